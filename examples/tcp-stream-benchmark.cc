@@ -0,0 +1,396 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// - Scaling benchmark of the tcp stream client and server
+// - Runs a fixed, deterministic scenario for a list of client counts, every run in its own process
+// - Scenario "wired": server -- router ==bottleneck== router -- clients (dumbbell)
+// - Scenario "wifi": server -- AP ~~802.11n~~ clients
+// - One CSV row per (scenario, numberOfClients) is appended to the output file
+// - With --arrivalRate > 0, clients arrive as a Poisson process and leave after an exponential session
+//   length, numberOfClients is then the size of the node pool, i.e. the maximum of concurrent clients
+//
+// ./waf --run="tcp-stream-benchmark --scenario=wired,wifi --clients=1,10,100,1000,2000 --adaptationAlgo=panda --segmentSizeFile=contrib/dash/segmentSizes.txt --output=bench.csv --label=v1"
+
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/tcp-stream-helper.h"
+#include "ns3/tcp-stream-interface.h"
+#include "ns3/tcp-stream-profiler.h"
+#include "ns3/tcp-stream-churn-manager.h"
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <errno.h>
+
+template <typename T>
+std::string ToString(T val)
+{
+    std::stringstream stream;
+    stream << val;
+    return stream.str();
+}
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamBenchmark");
+
+/**
+ * Parameters shared by all runs of one benchmark invocation.
+ */
+struct benchmarkConfig
+{
+  std::string label;
+  std::string adaptationAlgo;
+  std::string segmentSizeFilePath;
+  uint64_t segmentDuration;
+  double simulationTime;
+  double perClientRate;
+  uint32_t simulationId;
+  double arrivalRate;
+  double sessionLength;
+  bool fileLogging;
+};
+
+static std::vector<std::string>
+SplitList (std::string list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss (list);
+  std::string item;
+  while (std::getline (ss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+/**
+ * Build the wired dumbbell: every client has its own access link to the right router, the bottleneck
+ * capacity grows with the number of clients so that the per-client share stays constant.
+ */
+static Address
+BuildWired (const benchmarkConfig &config, uint32_t numberOfClients, NodeContainer &clientNodes, Ptr<Node> &serverNode)
+{
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer server;
+  server.Create (1);
+  serverNode = server.Get (0);
+  clientNodes.Create (numberOfClients);
+
+  InternetStackHelper stack;
+  stack.Install (routers);
+  stack.Install (server);
+  stack.Install (clientNodes);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper address;
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer serverLink = p2p.Install (serverNode, routers.Get (0));
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer serverInterface = address.Assign (serverLink);
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue (ToString (config.perClientRate * numberOfClients) + "Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  NetDeviceContainer bottleneck = p2p.Install (routers.Get (0), routers.Get (1));
+  address.SetBase ("10.0.1.0", "255.255.255.252");
+  address.Assign (bottleneck);
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  address.SetBase ("10.1.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < numberOfClients; i++)
+    {
+      NetDeviceContainer access = p2p.Install (routers.Get (1), clientNodes.Get (i));
+      address.Assign (access);
+      address.NewNetwork ();
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  return Address (serverInterface.GetAddress (0));
+}
+
+/**
+ * Build the WiFi variant of tcp-stream.cc without buildings: all stations are placed on a circle
+ * around the access point, the WAN link is shared by all clients.
+ */
+static Address
+BuildWifi (const benchmarkConfig &config, uint32_t numberOfClients, NodeContainer &clientNodes, Ptr<Node> &serverNode)
+{
+  NodeContainer infrastructure;
+  infrastructure.Create (2);
+  Ptr<Node> apNode = infrastructure.Get (0);
+  serverNode = infrastructure.Get (1);
+  clientNodes.Create (numberOfClients);
+
+  WifiHelper wifiHelper;
+  wifiHelper.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifiHelper.SetRemoteStationManager ("ns3::MinstrelHtWifiManager");
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper wifiPhy = YansWifiPhyHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  wifiPhy.Set ("ShortGuardEnabled", BooleanValue (true));
+
+  WifiMacHelper wifiMac;
+  Ssid ssid = Ssid ("network");
+  wifiMac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+  NetDeviceContainer staDevices = wifiHelper.Install (wifiPhy, wifiMac, clientNodes);
+  wifiMac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+  NetDeviceContainer apDevice = wifiHelper.Install (wifiPhy, wifiMac, apNode);
+  Config::Set ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/ChannelWidth", UintegerValue (40));
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100000kb/s"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("45ms"));
+  NetDeviceContainer wanDevices = p2p.Install (serverNode, apNode);
+
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (0.5, 0.5, 0.0));
+  for (uint32_t i = 0; i < numberOfClients; i++)
+    {
+      double angle = 2 * M_PI * i / numberOfClients;
+      positionAlloc->Add (Vector (5.0 * std::cos (angle), 5.0 * std::sin (angle), 0.0));
+    }
+  NodeContainer allNodes;
+  allNodes.Add (infrastructure);
+  allNodes.Add (clientNodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (allNodes);
+
+  InternetStackHelper stack;
+  stack.Install (allNodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("76.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer wanInterface = address.Assign (wanDevices);
+  address.SetBase ("192.168.0.0", "255.255.0.0");
+  address.Assign (staDevices);
+  address.Assign (apDevice);
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  return Address (wanInterface.GetAddress (0));
+}
+
+/**
+ * Run one scenario in the calling process and append the measured values to the output file.
+ */
+static int
+RunOnce (const benchmarkConfig &config, std::string scenario, uint32_t numberOfClients, std::string outputFile)
+{
+  typedef std::chrono::steady_clock clock;
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  TcpStreamProfiler::Reset ();
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1446));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (524288));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (524288));
+
+  clock::time_point setupStart = clock::now ();
+
+  NodeContainer clientNodes;
+  Ptr<Node> serverNode;
+  Address serverAddress;
+  if (scenario == "wired")
+    {
+      serverAddress = BuildWired (config, numberOfClients, clientNodes, serverNode);
+    }
+  else if (scenario == "wifi")
+    {
+      serverAddress = BuildWifi (config, numberOfClients, clientNodes, serverNode);
+    }
+  else
+    {
+      NS_LOG_ERROR ("Unknown scenario " << scenario);
+      return 1;
+    }
+
+  std::string simulationLogDir = dashLogDirectory + "/SimID_" + ToString (config.simulationId) + "/";
+  mkdir (dashLogDirectory.c_str (), 0775);
+  mkdir (simulationLogDir.c_str (), 0775);
+
+  std::vector <std::pair <Ptr<Node>, std::string> > clients;
+  for (uint32_t i = 0; i < numberOfClients; i++)
+    {
+      clients.push_back (std::make_pair (clientNodes.Get (i), config.adaptationAlgo));
+    }
+
+  uint16_t port = 9;
+  TcpStreamServerHelper serverHelper (port);
+  // the CSV splits the wall clock time into client and server, which needs their profiling counters
+  serverHelper.SetAttribute ("Profiling", BooleanValue (true));
+  ApplicationContainer serverApp = serverHelper.Install (serverNode);
+  serverApp.Start (Seconds (0.5));
+
+  TcpStreamClientHelper clientHelper (serverAddress, port);
+  clientHelper.SetAttribute ("SegmentDuration", UintegerValue (config.segmentDuration));
+  clientHelper.SetAttribute ("SegmentSizeFilePath", StringValue (config.segmentSizeFilePath));
+  clientHelper.SetAttribute ("NumberOfClients", UintegerValue (numberOfClients));
+  clientHelper.SetAttribute ("SimulationId", UintegerValue (config.simulationId));
+  clientHelper.SetAttribute ("Profiling", BooleanValue (true));
+  clientHelper.SetAttribute ("AlgorithmProfiling", BooleanValue (true));
+  // thousands of clients with a dozen log files each would exceed the file descriptor limit and
+  // measure the disk instead of the simulator
+  clientHelper.SetAttribute ("EnableFileLogging", BooleanValue (config.fileLogging));
+  Ptr<TcpStreamChurnManager> churnManager;
+  if (config.arrivalRate > 0)
+    {
+      serverApp.Get (0)->SetAttribute ("StopWhenIdle", BooleanValue (false));
+      clientHelper.SetChurnAttribute ("ArrivalRate", DoubleValue (config.arrivalRate));
+      clientHelper.SetChurnAttribute ("SessionLength", StringValue ("ns3::ExponentialRandomVariable[Mean=" + ToString (config.sessionLength) + "]"));
+      clientHelper.SetChurnAttribute ("MaxClients", UintegerValue (0));
+      clientHelper.SetChurnAttribute ("StopTime", TimeValue (Seconds (config.simulationTime - 1.0)));
+      clientHelper.SetChurnAttribute ("SimulationId", UintegerValue (config.simulationId));
+      churnManager = clientHelper.InstallChurn (clientNodes, config.adaptationAlgo, Seconds (1.0));
+    }
+  else
+    {
+      ApplicationContainer clientApps = clientHelper.Install (clients);
+      for (uint32_t i = 0; i < clientApps.GetN (); i++)
+        {
+          // deterministic start times, spread over one second
+          clientApps.Get (i)->SetStartTime (Seconds (1.0 + (i % 100) / 100.0));
+        }
+    }
+
+  clock::time_point runStart = clock::now ();
+  Simulator::Stop (Seconds (config.simulationTime));
+  Simulator::Run ();
+  clock::time_point runEnd = clock::now ();
+
+  double simulatedSeconds = Simulator::Now ().GetSeconds ();
+  uint64_t events = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+
+  double setupWall = std::chrono::duration<double> (runStart - setupStart).count ();
+  double runWall = std::chrono::duration<double> (runEnd - runStart).count ();
+  double clientWall = TcpStreamProfiler::GetComponent (TcpStreamProfiler::CLIENT).wallTime / 1e9;
+  double serverWall = TcpStreamProfiler::GetComponent (TcpStreamProfiler::SERVER).wallTime / 1e9;
+  uint64_t segments = TcpStreamProfiler::GetSegments ().calls;
+
+  std::ofstream csv (outputFile.c_str (), std::ios::app);
+  csv << config.label << ","
+      << scenario << ","
+      << numberOfClients << ","
+      << config.adaptationAlgo << ","
+      << simulatedSeconds << ","
+      << setupWall << ","
+      << runWall << ","
+      << (runWall > 0 ? simulatedSeconds / runWall : 0) << ","
+      << events << ","
+      << (runWall > 0 ? events / runWall : 0) << ","
+      << segments << ","
+      << (segments > 0 ? events / (double) segments : 0) << ","
+      << usage.ru_maxrss << ","
+      << clientWall << ","
+      << serverWall << ","
+      << std::max (0.0, runWall - clientWall - serverWall) << ","
+      << config.fileLogging << "\n";
+  csv.close ();
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  benchmarkConfig config;
+  config.label = "current";
+  config.adaptationAlgo = "panda";
+  config.segmentSizeFilePath = "contrib/dash/segmentSizes.txt";
+  config.segmentDuration = 2000000;
+  config.simulationTime = 60;
+  config.perClientRate = 5;
+  config.simulationId = 0;
+  config.arrivalRate = 0;
+  config.sessionLength = 60;
+  config.fileLogging = false;
+  std::string scenarios = "wired,wifi";
+  std::string clientCounts = "1,10,50,100,200,500,1000,2000";
+  std::string outputFile = "tcp-stream-benchmark.csv";
+
+  CommandLine cmd;
+  cmd.Usage ("Scaling benchmark of the tcp stream applications.\n");
+  cmd.AddValue ("label", "A label identifying the measured library version, written to every row", config.label);
+  cmd.AddValue ("scenario", "Comma separated list of scenarios (wired, wifi)", scenarios);
+  cmd.AddValue ("clients", "Comma separated list of client counts", clientCounts);
+  cmd.AddValue ("adaptationAlgo", "The adaptation algorithm that the clients use", config.adaptationAlgo);
+  cmd.AddValue ("segmentDuration", "The duration of a video segment in microseconds", config.segmentDuration);
+  cmd.AddValue ("segmentSizeFile", "The relative path (from ns-3.x directory) to the file containing the segment sizes in bytes", config.segmentSizeFilePath);
+  cmd.AddValue ("simulationTime", "Simulated seconds per run", config.simulationTime);
+  cmd.AddValue ("perClientRate", "Bottleneck capacity per client in Mbps (wired scenario)", config.perClientRate);
+  cmd.AddValue ("simulationId", "The simulation's index (for logging purposes)", config.simulationId);
+  cmd.AddValue ("arrivalRate", "Poisson client arrivals per second, 0 to start all clients at once", config.arrivalRate);
+  cmd.AddValue ("sessionLength", "Mean session length in seconds with arrivalRate > 0", config.sessionLength);
+  cmd.AddValue ("fileLogging", "Write the per client log files (slow, and needs a raised file descriptor limit for many clients)", config.fileLogging);
+  cmd.AddValue ("output", "The CSV file the results are appended to", outputFile);
+  cmd.Parse (argc, argv);
+
+  std::ifstream existing (outputFile.c_str ());
+  bool writeHeader = !existing.good () || existing.peek () == std::ifstream::traits_type::eof ();
+  existing.close ();
+  if (writeHeader)
+    {
+      std::ofstream csv (outputFile.c_str ());
+      csv << "label,scenario,clients,algorithm,sim_time_s,setup_wall_s,run_wall_s,sim_s_per_wall_s,"
+          << "events,events_per_wall_s,segments,events_per_segment,peak_rss_kb,"
+          << "client_wall_s,server_wall_s,network_wall_s,file_logging\n";
+    }
+
+  std::vector<std::string> scenarioList = SplitList (scenarios);
+  std::vector<std::string> clientList = SplitList (clientCounts);
+  int failures = 0;
+  for (uint32_t s = 0; s < scenarioList.size (); s++)
+    {
+      for (uint32_t c = 0; c < clientList.size (); c++)
+        {
+          uint32_t numberOfClients = std::stoul (clientList.at (c));
+          std::cout << "Running " << scenarioList.at (s) << " with " << numberOfClients << " clients" << std::endl;
+          // every run gets its own process, so that peak RSS and the simulator state are not shared between runs
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              _exit (RunOnce (config, scenarioList.at (s), numberOfClients, outputFile));
+            }
+          int status = 0;
+          if (pid < 0 || waitpid (pid, &status, 0) < 0 || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+            {
+              std::cerr << "Run " << scenarioList.at (s) << "/" << numberOfClients << " failed" << std::endl;
+              failures++;
+            }
+        }
+    }
+  return failures == 0 ? 0 : 1;
+}
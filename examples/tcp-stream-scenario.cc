@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// - Client groups with different algorithms, videos and start times, read from a scenario file
+// - server -- router ==bottleneck== router -- clients (dumbbell), the bottleneck is shared by all groups
+// - See tcp-stream-scenario.txt for the file format
+//
+// ./waf --run="tcp-stream-scenario --scenarioFile=contrib/dash/examples/tcp-stream-scenario.txt --simulationId=1"
+
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/tcp-stream-helper.h"
+#include "ns3/tcp-stream-scenario-helper.h"
+#include "ns3/tcp-stream-interface.h"
+#include <sys/stat.h>
+#include <sys/types.h>
+
+template <typename T>
+std::string ToString(T val)
+{
+    std::stringstream stream;
+    stream << val;
+    return stream.str();
+}
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamScenarioExample");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t simulationId = 0;
+  std::string scenarioFile = "contrib/dash/examples/tcp-stream-scenario.txt";
+  std::string bottleneckRate = "20Mbps";
+  double simulationTime = 0;
+
+  CommandLine cmd;
+  cmd.Usage ("Simulation of heterogeneous DASH client groups described in a scenario file.\n");
+  cmd.AddValue ("simulationId", "The simulation's index (for logging purposes)", simulationId);
+  cmd.AddValue ("scenarioFile", "The scenario file with the client groups", scenarioFile);
+  cmd.AddValue ("bottleneckRate", "The data rate of the bottleneck link", bottleneckRate);
+  cmd.AddValue ("simulationTime", "Simulated seconds, 0 to run until all clients finished", simulationTime);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1446));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (524288));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (524288));
+
+  // the default lines of the scenario file may overwrite the defaults above
+  TcpStreamScenarioHelper scenario;
+  if (!scenario.Load (scenarioFile))
+    {
+      return 1;
+    }
+  uint32_t numberOfClients = scenario.GetNClients ();
+
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer server;
+  server.Create (1);
+  NodeContainer clientNodes;
+  clientNodes.Create (numberOfClients);
+
+  InternetStackHelper stack;
+  stack.Install (routers);
+  stack.Install (server);
+  stack.Install (clientNodes);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper address;
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer serverLink = p2p.Install (server.Get (0), routers.Get (0));
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer serverInterface = address.Assign (serverLink);
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue (bottleneckRate));
+  p2p.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  NetDeviceContainer bottleneck = p2p.Install (routers.Get (0), routers.Get (1));
+  address.SetBase ("10.0.1.0", "255.255.255.252");
+  address.Assign (bottleneck);
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  address.SetBase ("10.1.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < numberOfClients; i++)
+    {
+      NetDeviceContainer access = p2p.Install (routers.Get (1), clientNodes.Get (i));
+      address.Assign (access);
+      address.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  std::string simulationLogDir = dashLogDirectory + "/SimID_" + ToString (simulationId) + "/";
+  mkdir (dashLogDirectory.c_str (), 0775);
+  mkdir (simulationLogDir.c_str (), 0775);
+
+  uint16_t port = 9;
+  TcpStreamServerHelper serverHelper (port);
+  ApplicationContainer serverApp = serverHelper.Install (server.Get (0));
+  serverApp.Start (Seconds (1.0));
+
+  TcpStreamClientHelper clientHelper (Address (serverInterface.GetAddress (0)), port);
+  clientHelper.SetAttribute ("SimulationId", UintegerValue (simulationId));
+  ApplicationContainer clientApps = scenario.Install (clientHelper, clientNodes);
+  scenario.ConfigureAttributes ();
+
+  NS_LOG_INFO ("Run Simulation.");
+  NS_LOG_INFO ("Sim: " << simulationId << " Clients: " << numberOfClients);
+  if (simulationTime > 0)
+    {
+      Simulator::Stop (Seconds (simulationTime));
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_LOG_INFO ("Done.");
+  return 0;
+}
@@ -0,0 +1,803 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// - Automatic tuning of adaptation algorithm attributes with CMA-ES
+// - Every candidate parameter set is simulated runs times (with the same seeds for all candidates) on the
+//   scenario of tcp-stream-scenario.cc, every simulation in its own worker process
+// - The objective is a weighted sum of the fleet metrics in qoeSummary.txt, it is maximized
+// - A candidate whose mean objective after a run is worse than the best complete candidate by more than
+//   earlyStopMargin (relative) is not simulated any further
+// - The best parameter set is written as ConfigStore default lines, one CSV row per generation to the report
+//
+// ./waf --run="tcp-stream-tuner --scenarioFile=contrib/dash/examples/tcp-stream-scenario.txt --adaptationAlgo=panda --space=ns3::PandaAlgorithm::Kappa=0.05:0.5,ns3::PandaAlgorithm::Omega=0.1:1,ns3::PandaAlgorithm::BMin=5:40:int --workers=8"
+
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/network-module.h"
+#include "ns3/tcp-stream-helper.h"
+#include "ns3/tcp-stream-scenario-helper.h"
+#include "ns3/tcp-stream-interface.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+template <typename T>
+std::string ToString(T val)
+{
+    std::stringstream stream;
+    stream << val;
+    return stream.str();
+}
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamTuner");
+
+/**
+ * One dimension of the parameter space: an attribute default and its range.
+ */
+struct tunerParameter
+{
+  std::string name; //!< the attribute path, e.g. ns3::PandaAlgorithm::Kappa
+  double min; //!< the lowest value
+  double max; //!< the highest value
+  bool integer; //!< true if the attribute only takes integers
+};
+
+/**
+ * Parameters shared by all simulations of one tuner invocation.
+ */
+struct tunerConfig
+{
+  std::string scenarioFile;
+  std::string adaptationAlgo;
+  std::string bottleneckRate;
+  double simulationTime;
+  uint32_t runs;
+  uint32_t workers;
+  double earlyStopMargin;
+  std::vector<tunerParameter> space;
+  std::vector<std::pair<std::string, double> > objective;
+};
+
+/**
+ * A candidate parameter set and its simulation results so far.
+ */
+struct tunerCandidate
+{
+  std::vector<double> point; //!< the parameters, normalized to [0, 1]
+  double scoreSum; //!< the sum of the objective over the finished runs
+  uint32_t runs; //!< the number of finished runs
+  bool stopped; //!< true if no further runs are simulated
+  bool failed; //!< true if a run failed
+};
+
+static std::vector<std::string>
+SplitList (std::string list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss (list);
+  std::string item;
+  while (std::getline (ss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+/**
+ * Parse "name=min:max[:int],...".
+ */
+static bool
+ParseSpace (std::string list, std::vector<tunerParameter> &space)
+{
+  std::vector<std::string> items = SplitList (list);
+  for (uint32_t i = 0; i < items.size (); i++)
+    {
+      size_t equals = items.at (i).rfind ('=');
+      if (equals == std::string::npos)
+        {
+          return false;
+        }
+      tunerParameter parameter;
+      parameter.name = items.at (i).substr (0, equals);
+      std::string range = items.at (i).substr (equals + 1);
+      std::replace (range.begin (), range.end (), ':', ' ');
+      std::istringstream buffer (range);
+      std::string type;
+      if (!(buffer >> parameter.min >> parameter.max) || parameter.max <= parameter.min)
+        {
+          return false;
+        }
+      parameter.integer = (buffer >> type) && type == "int";
+      space.push_back (parameter);
+    }
+  return !space.empty ();
+}
+
+/**
+ * Parse "metric=weight,...", the metrics are the names of the fleet lines of qoeSummary.txt.
+ */
+static bool
+ParseObjective (std::string list, std::vector<std::pair<std::string, double> > &objective)
+{
+  std::vector<std::string> items = SplitList (list);
+  for (uint32_t i = 0; i < items.size (); i++)
+    {
+      size_t equals = items.at (i).find ('=');
+      double weight;
+      std::istringstream buffer (equals == std::string::npos ? "" : items.at (i).substr (equals + 1));
+      if (!(buffer >> weight))
+        {
+          return false;
+        }
+      objective.push_back (std::make_pair (items.at (i).substr (0, equals), weight));
+    }
+  return !objective.empty ();
+}
+
+/**
+ * \return the attribute value of the normalized coordinate x of parameter
+ */
+static std::string
+FormatValue (const tunerParameter &parameter, double x)
+{
+  double value = parameter.min + x * (parameter.max - parameter.min);
+  if (parameter.integer)
+    {
+      return ToString ((int64_t) std::floor (value + 0.5));
+    }
+  return ToString (value);
+}
+
+/**
+ * Simulate one run of a candidate in the calling process, the QoE summary is written to the log
+ * directory of simulationId.
+ */
+static int
+RunOnce (const tunerConfig &config, const std::vector<double> &point, uint32_t run, uint32_t simulationId)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (run + 1);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1446));
+  Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (524288));
+  Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (524288));
+
+  TcpStreamScenarioHelper scenario;
+  if (!scenario.Load (config.scenarioFile))
+    {
+      return 1;
+    }
+  if (!config.adaptationAlgo.empty ())
+    {
+      scenario.SetAlgorithm (config.adaptationAlgo);
+    }
+  // after Load, so that the candidate overrides the default lines of the scenario file
+  for (uint32_t p = 0; p < config.space.size (); p++)
+    {
+      Config::SetDefault (config.space.at (p).name, StringValue (FormatValue (config.space.at (p), point.at (p))));
+    }
+  uint32_t numberOfClients = scenario.GetNClients ();
+
+  NodeContainer routers;
+  routers.Create (2);
+  NodeContainer server;
+  server.Create (1);
+  NodeContainer clientNodes;
+  clientNodes.Create (numberOfClients);
+
+  InternetStackHelper stack;
+  stack.Install (routers);
+  stack.Install (server);
+  stack.Install (clientNodes);
+
+  PointToPointHelper p2p;
+  Ipv4AddressHelper address;
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer serverLink = p2p.Install (server.Get (0), routers.Get (0));
+  address.SetBase ("10.0.0.0", "255.255.255.252");
+  Ipv4InterfaceContainer serverInterface = address.Assign (serverLink);
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue (config.bottleneckRate));
+  p2p.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  NetDeviceContainer bottleneck = p2p.Install (routers.Get (0), routers.Get (1));
+  address.SetBase ("10.0.1.0", "255.255.255.252");
+  address.Assign (bottleneck);
+
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  address.SetBase ("10.1.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < numberOfClients; i++)
+    {
+      NetDeviceContainer access = p2p.Install (routers.Get (1), clientNodes.Get (i));
+      address.Assign (access);
+      address.NewNetwork ();
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  std::string simulationLogDir = dashLogDirectory + "/SimID_" + ToString (simulationId) + "/";
+  mkdir (dashLogDirectory.c_str (), 0775);
+  mkdir (simulationLogDir.c_str (), 0775);
+
+  uint16_t port = 9;
+  TcpStreamServerHelper serverHelper (port);
+  ApplicationContainer serverApp = serverHelper.Install (server.Get (0));
+  serverApp.Start (Seconds (1.0));
+
+  TcpStreamClientHelper clientHelper (Address (serverInterface.GetAddress (0)), port);
+  clientHelper.SetAttribute ("SimulationId", UintegerValue (simulationId));
+  scenario.Install (clientHelper, clientNodes);
+  scenario.ConfigureAttributes ();
+
+  if (config.simulationTime > 0)
+    {
+      Simulator::Stop (Seconds (config.simulationTime));
+    }
+  Simulator::Run ();
+  // the QoE summary is written when the last client is disposed
+  Simulator::Destroy ();
+  return 0;
+}
+
+/**
+ * \return false if the QoE summary of simulationId is missing a metric of the objective
+ */
+static bool
+ReadObjective (const tunerConfig &config, uint32_t simulationId, double &score)
+{
+  std::string path = dashLogDirectory + "/SimID_" + ToString (simulationId) + "/qoeSummary.txt";
+  std::ifstream file (path.c_str ());
+  std::map<std::string, double> metrics;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream buffer (line);
+      std::string name;
+      double value;
+      if (buffer >> name >> value)
+        {
+          // the first value of a line, the fleet metrics come before the client lines
+          metrics.insert (std::make_pair (name, value));
+        }
+    }
+  score = 0;
+  for (uint32_t i = 0; i < config.objective.size (); i++)
+    {
+      std::map<std::string, double>::const_iterator it = metrics.find (config.objective.at (i).first);
+      if (it == metrics.end ())
+        {
+          NS_LOG_ERROR (path << " has no " << config.objective.at (i).first);
+          return false;
+        }
+      score += config.objective.at (i).second * it->second;
+    }
+  return true;
+}
+
+/**
+ * Simulate the next run of all candidates that are not stopped, at most config.workers at once.
+ *
+ * \return the number of simulations
+ */
+static uint32_t
+RunRound (const tunerConfig &config, std::vector<tunerCandidate> &candidates, uint32_t &nextSimulationId)
+{
+  std::vector<uint32_t> pending;
+  for (uint32_t c = 0; c < candidates.size (); c++)
+    {
+      if (!candidates.at (c).stopped)
+        {
+          pending.push_back (c);
+        }
+    }
+  // the running workers, by process id: candidate and simulation id
+  std::map<pid_t, std::pair<uint32_t, uint32_t> > running;
+  uint32_t next = 0;
+  while (next < pending.size () || !running.empty ())
+    {
+      if (next < pending.size () && running.size () < config.workers)
+        {
+          tunerCandidate &candidate = candidates.at (pending.at (next));
+          uint32_t simulationId = nextSimulationId++;
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              _exit (RunOnce (config, candidate.point, candidate.runs, simulationId));
+            }
+          if (pid < 0)
+            {
+              std::cerr << "Starting a worker failed" << std::endl;
+              candidate.failed = true;
+              candidate.stopped = true;
+            }
+          else
+            {
+              running[pid] = std::make_pair (pending.at (next), simulationId);
+            }
+          next++;
+          continue;
+        }
+      int status = 0;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          break;
+        }
+      std::map<pid_t, std::pair<uint32_t, uint32_t> >::iterator it = running.find (pid);
+      if (it == running.end ())
+        {
+          continue;
+        }
+      tunerCandidate &candidate = candidates.at (it->second.first);
+      double score;
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0 || !ReadObjective (config, it->second.second, score))
+        {
+          std::cerr << "Simulation " << it->second.second << " failed" << std::endl;
+          candidate.failed = true;
+          candidate.stopped = true;
+        }
+      else
+        {
+          candidate.scoreSum += score;
+          candidate.runs++;
+        }
+      running.erase (it);
+    }
+  return next;
+}
+
+/**
+ * \brief (mu/mu_w, lambda)-CMA-ES on [0, 1]^n, maximizing; samples outside are clamped to the bounds.
+ */
+class CmaEs
+{
+public:
+  CmaEs (uint32_t n, double sigma, uint32_t lambda, uint32_t seed)
+    : m_n (n),
+      m_lambda (lambda),
+      m_mu (lambda / 2),
+      m_generation (0),
+      m_sigma (sigma),
+      m_mean (n, 0.5),
+      m_pc (n, 0),
+      m_ps (n, 0),
+      m_c (n * n, 0),
+      m_b (n * n, 0),
+      m_d (n, 1),
+      m_random (seed)
+  {
+    double sum = 0;
+    for (uint32_t i = 0; i < m_mu; i++)
+      {
+        m_weights.push_back (std::log (m_mu + 0.5) - std::log (i + 1.0));
+        sum += m_weights.back ();
+      }
+    double squares = 0;
+    for (uint32_t i = 0; i < m_mu; i++)
+      {
+        m_weights.at (i) /= sum;
+        squares += m_weights.at (i) * m_weights.at (i);
+      }
+    m_mueff = 1 / squares;
+    m_cc = (4 + m_mueff / n) / (n + 4 + 2 * m_mueff / n);
+    m_cs = (m_mueff + 2) / (n + m_mueff + 5);
+    m_c1 = 2 / ((n + 1.3) * (n + 1.3) + m_mueff);
+    m_cmu = std::min (1 - m_c1, 2 * (m_mueff - 2 + 1 / m_mueff) / ((n + 2) * (n + 2) + m_mueff));
+    m_damps = 1 + 2 * std::max (0.0, std::sqrt ((m_mueff - 1) / (n + 1)) - 1) + m_cs;
+    m_chiN = std::sqrt ((double) n) * (1 - 1.0 / (4 * n) + 1.0 / (21.0 * n * n));
+    for (uint32_t i = 0; i < n; i++)
+      {
+        m_c.at (i * n + i) = 1;
+        m_b.at (i * n + i) = 1;
+      }
+  }
+
+  /**
+   * \brief Draw a generation of lambda points.
+   */
+  void Sample (std::vector<std::vector<double> > &points)
+  {
+    std::normal_distribution<double> normal (0, 1);
+    points.assign (m_lambda, std::vector<double> (m_n, 0));
+    m_steps.assign (m_lambda, std::vector<double> (m_n, 0));
+    std::vector<double> z (m_n);
+    for (uint32_t k = 0; k < m_lambda; k++)
+      {
+        for (uint32_t i = 0; i < m_n; i++)
+          {
+            z.at (i) = m_d.at (i) * normal (m_random);
+          }
+        for (uint32_t i = 0; i < m_n; i++)
+          {
+            double y = 0;
+            for (uint32_t j = 0; j < m_n; j++)
+              {
+                y += m_b.at (i * m_n + j) * z.at (j);
+              }
+            double x = std::min (std::max (m_mean.at (i) + m_sigma * y, 0.0), 1.0);
+            points.at (k).at (i) = x;
+            // the step that was actually taken, after clamping
+            m_steps.at (k).at (i) = (x - m_mean.at (i)) / m_sigma;
+          }
+      }
+  }
+
+  /**
+   * \brief Update the distribution with the objective of every point of the last Sample (), higher is better.
+   */
+  void Update (const std::vector<double> &scores)
+  {
+    std::vector<uint32_t> order (m_lambda);
+    for (uint32_t k = 0; k < m_lambda; k++)
+      {
+        order.at (k) = k;
+      }
+    std::stable_sort (order.begin (), order.end (), ScoreOrder (scores));
+
+    std::vector<double> yw (m_n, 0);
+    for (uint32_t k = 0; k < m_mu; k++)
+      {
+        for (uint32_t i = 0; i < m_n; i++)
+          {
+            yw.at (i) += m_weights.at (k) * m_steps.at (order.at (k)).at (i);
+          }
+      }
+    for (uint32_t i = 0; i < m_n; i++)
+      {
+        m_mean.at (i) = std::min (std::max (m_mean.at (i) + m_sigma * yw.at (i), 0.0), 1.0);
+      }
+
+    // C^-1/2 * yw = B * D^-1 * B^T * yw
+    std::vector<double> rotated (m_n, 0);
+    for (uint32_t j = 0; j < m_n; j++)
+      {
+        for (uint32_t i = 0; i < m_n; i++)
+          {
+            rotated.at (j) += m_b.at (i * m_n + j) * yw.at (i);
+          }
+        rotated.at (j) /= m_d.at (j);
+      }
+    double psNorm = 0;
+    for (uint32_t i = 0; i < m_n; i++)
+      {
+        double whitened = 0;
+        for (uint32_t j = 0; j < m_n; j++)
+          {
+            whitened += m_b.at (i * m_n + j) * rotated.at (j);
+          }
+        m_ps.at (i) = (1 - m_cs) * m_ps.at (i) + std::sqrt (m_cs * (2 - m_cs) * m_mueff) * whitened;
+        psNorm += m_ps.at (i) * m_ps.at (i);
+      }
+    psNorm = std::sqrt (psNorm);
+    m_generation++;
+    bool hsig = psNorm / std::sqrt (1 - std::pow (1 - m_cs, 2.0 * m_generation)) / m_chiN < 1.4 + 2.0 / (m_n + 1);
+    for (uint32_t i = 0; i < m_n; i++)
+      {
+        m_pc.at (i) = (1 - m_cc) * m_pc.at (i) + (hsig ? std::sqrt (m_cc * (2 - m_cc) * m_mueff) : 0) * yw.at (i);
+      }
+    for (uint32_t i = 0; i < m_n; i++)
+      {
+        for (uint32_t j = 0; j < m_n; j++)
+          {
+            double rankMu = 0;
+            for (uint32_t k = 0; k < m_mu; k++)
+              {
+                const std::vector<double> &y = m_steps.at (order.at (k));
+                rankMu += m_weights.at (k) * y.at (i) * y.at (j);
+              }
+            double &c = m_c.at (i * m_n + j);
+            c = (1 - m_c1 - m_cmu) * c
+              + m_c1 * (m_pc.at (i) * m_pc.at (j) + (hsig ? 0 : m_cc * (2 - m_cc) * c))
+              + m_cmu * rankMu;
+          }
+      }
+    // the whole space has width 1, a larger step size only produces clamped points
+    m_sigma = std::min (m_sigma * std::exp ((m_cs / m_damps) * (psNorm / m_chiN - 1)), 1.0);
+    Decompose ();
+  }
+
+  double GetSigma () const
+  {
+    return m_sigma;
+  }
+
+private:
+  /**
+   * \brief Sort the points by descending score.
+   */
+  struct ScoreOrder
+  {
+    ScoreOrder (const std::vector<double> &scores) : m_scores (scores) {}
+    bool operator() (uint32_t a, uint32_t b) const
+    {
+      return m_scores.at (a) > m_scores.at (b);
+    }
+    const std::vector<double> &m_scores;
+  };
+
+  /**
+   * \brief Eigendecomposition C = B * diag (D^2) * B^T by cyclic Jacobi rotations, n is small.
+   */
+  void Decompose ()
+  {
+    std::vector<double> a = m_c;
+    std::fill (m_b.begin (), m_b.end (), 0.0);
+    for (uint32_t i = 0; i < m_n; i++)
+      {
+        m_b.at (i * m_n + i) = 1;
+      }
+    for (uint32_t sweep = 0; sweep < 50; sweep++)
+      {
+        double off = 0;
+        for (uint32_t p = 0; p < m_n; p++)
+          {
+            for (uint32_t q = p + 1; q < m_n; q++)
+              {
+                off += a.at (p * m_n + q) * a.at (p * m_n + q);
+              }
+          }
+        if (off < 1e-30)
+          {
+            break;
+          }
+        for (uint32_t p = 0; p < m_n; p++)
+          {
+            for (uint32_t q = p + 1; q < m_n; q++)
+              {
+                double apq = a.at (p * m_n + q);
+                if (std::fabs (apq) < 1e-300)
+                  {
+                    continue;
+                  }
+                double theta = (a.at (q * m_n + q) - a.at (p * m_n + p)) / (2 * apq);
+                double t = (theta >= 0 ? 1 : -1) / (std::fabs (theta) + std::sqrt (theta * theta + 1));
+                double c = 1 / std::sqrt (t * t + 1);
+                double s = t * c;
+                for (uint32_t k = 0; k < m_n; k++)
+                  {
+                    double akp = a.at (k * m_n + p);
+                    double akq = a.at (k * m_n + q);
+                    a.at (k * m_n + p) = c * akp - s * akq;
+                    a.at (k * m_n + q) = s * akp + c * akq;
+                  }
+                for (uint32_t k = 0; k < m_n; k++)
+                  {
+                    double apk = a.at (p * m_n + k);
+                    double aqk = a.at (q * m_n + k);
+                    a.at (p * m_n + k) = c * apk - s * aqk;
+                    a.at (q * m_n + k) = s * apk + c * aqk;
+                  }
+                for (uint32_t k = 0; k < m_n; k++)
+                  {
+                    double bkp = m_b.at (k * m_n + p);
+                    double bkq = m_b.at (k * m_n + q);
+                    m_b.at (k * m_n + p) = c * bkp - s * bkq;
+                    m_b.at (k * m_n + q) = s * bkp + c * bkq;
+                  }
+              }
+          }
+      }
+    for (uint32_t i = 0; i < m_n; i++)
+      {
+        m_d.at (i) = std::sqrt (std::max (a.at (i * m_n + i), 1e-20));
+      }
+  }
+
+  uint32_t m_n; //!< the number of parameters
+  uint32_t m_lambda; //!< the population size
+  uint32_t m_mu; //!< the number of points the mean is computed from
+  uint32_t m_generation; //!< the number of updates so far
+  double m_sigma; //!< the step size
+  std::vector<double> m_weights; //!< the recombination weights of the mu best points
+  double m_mueff; //!< the variance effective selection mass
+  double m_cc; //!< learning rate of the covariance path
+  double m_cs; //!< learning rate of the step size path
+  double m_c1; //!< learning rate of the rank-one update
+  double m_cmu; //!< learning rate of the rank-mu update
+  double m_damps; //!< damping of the step size update
+  double m_chiN; //!< expected norm of an n-dimensional standard normal vector
+  std::vector<double> m_mean; //!< the mean of the distribution
+  std::vector<double> m_pc; //!< the evolution path of the covariance
+  std::vector<double> m_ps; //!< the evolution path of the step size
+  std::vector<double> m_c; //!< the covariance matrix, row major
+  std::vector<double> m_b; //!< the eigenvectors of m_c, in the columns
+  std::vector<double> m_d; //!< the square roots of the eigenvalues of m_c
+  std::vector<std::vector<double> > m_steps; //!< the steps of the last sample, divided by m_sigma
+  std::mt19937 m_random; //!< the random number generator of the samples
+};
+
+int
+main (int argc, char *argv[])
+{
+  tunerConfig config;
+  config.scenarioFile = "contrib/dash/examples/tcp-stream-scenario.txt";
+  config.bottleneckRate = "20Mbps";
+  config.simulationTime = 0;
+  config.runs = 3;
+  config.workers = 4;
+  config.earlyStopMargin = 0.1;
+  std::string space;
+  std::string objective = "Mean_Average_Bitrate_Kbps=0.001,Mean_Rebuffer_Ratio=-10,Mean_Switches=-0.01,Mean_Startup_Delay=-0.1";
+  uint32_t generations = 10;
+  uint32_t population = 0;
+  double sigma = 0.3;
+  uint32_t seed = 1;
+  uint32_t simulationId = 1000;
+  std::string outputFile = "tcp-stream-tuner.txt";
+  std::string reportFile = "tcp-stream-tuner.csv";
+
+  CommandLine cmd;
+  cmd.Usage ("Tuning of adaptation algorithm attributes with CMA-ES on a scenario file.\n");
+  cmd.AddValue ("scenarioFile", "The scenario file with the client groups, see tcp-stream-scenario", config.scenarioFile);
+  cmd.AddValue ("adaptationAlgo", "The adaptation algorithm of all client groups, empty to keep the algorithms of the scenario file", config.adaptationAlgo);
+  cmd.AddValue ("space", "The parameter space, a comma separated list of attribute=min:max, or attribute=min:max:int for integer attributes", space);
+  cmd.AddValue ("objective", "The objective to maximize, a comma separated list of metric=weight over the fleet metrics of qoeSummary.txt", objective);
+  cmd.AddValue ("bottleneckRate", "The data rate of the bottleneck link", config.bottleneckRate);
+  cmd.AddValue ("simulationTime", "Simulated seconds per run, 0 to run until all clients finished", config.simulationTime);
+  cmd.AddValue ("runs", "The number of runs (seeds) per candidate", config.runs);
+  cmd.AddValue ("workers", "The number of simulations run in parallel", config.workers);
+  cmd.AddValue ("earlyStopMargin", "Stop a candidate whose mean objective is worse than the best one by more than this share of it, negative to always simulate all runs", config.earlyStopMargin);
+  cmd.AddValue ("generations", "The number of CMA-ES generations", generations);
+  cmd.AddValue ("population", "The number of candidates per generation, 0 for 4 + 3 ln (number of parameters)", population);
+  cmd.AddValue ("sigma", "The initial step size, as a share of the parameter ranges", sigma);
+  cmd.AddValue ("seed", "The seed of the candidate sampling", seed);
+  cmd.AddValue ("simulationId", "The simulation id of the first simulation, the following ones count up", simulationId);
+  cmd.AddValue ("output", "The file the best parameter set is written to, as ConfigStore default lines", outputFile);
+  cmd.AddValue ("report", "The CSV file with one row per generation", reportFile);
+  cmd.Parse (argc, argv);
+
+  if (!ParseSpace (space, config.space))
+    {
+      std::cerr << "Invalid parameter space '" << space << "'" << std::endl;
+      return 1;
+    }
+  if (!ParseObjective (objective, config.objective))
+    {
+      std::cerr << "Invalid objective '" << objective << "'" << std::endl;
+      return 1;
+    }
+  config.runs = std::max (config.runs, (uint32_t) 1);
+  config.workers = std::max (config.workers, (uint32_t) 1);
+  uint32_t n = config.space.size ();
+  if (population < 2)
+    {
+      population = 4 + (uint32_t) std::floor (3 * std::log ((double) n));
+    }
+
+  std::ofstream report (reportFile.c_str ());
+  report << "generation,simulations,early_stops,failures,best_score,generation_best,generation_mean,sigma";
+  for (uint32_t p = 0; p < n; p++)
+    {
+      report << "," << config.space.at (p).name;
+    }
+  report << "\n";
+
+  CmaEs es (n, sigma, population, seed);
+  std::vector<double> best;
+  double bestScore = -std::numeric_limits<double>::infinity ();
+  uint32_t bestGeneration = 0;
+  uint32_t simulations = 0;
+  uint32_t earlyStops = 0;
+  uint32_t failures = 0;
+  for (uint32_t g = 0; g < generations; g++)
+    {
+      std::vector<std::vector<double> > points;
+      es.Sample (points);
+      std::vector<tunerCandidate> candidates (points.size ());
+      for (uint32_t c = 0; c < candidates.size (); c++)
+        {
+          candidates.at (c).point = points.at (c);
+          candidates.at (c).scoreSum = 0;
+          candidates.at (c).runs = 0;
+          candidates.at (c).stopped = false;
+          candidates.at (c).failed = false;
+        }
+      std::cout << "Generation " << g << ": " << candidates.size () << " candidates, sigma " << es.GetSigma () << std::endl;
+
+      for (uint32_t r = 0; r < config.runs; r++)
+        {
+          simulations += RunRound (config, candidates, simulationId);
+          for (uint32_t c = 0; c < candidates.size (); c++)
+            {
+              tunerCandidate &candidate = candidates.at (c);
+              if (candidate.stopped || r + 1 == config.runs || config.earlyStopMargin < 0
+                  || bestScore == -std::numeric_limits<double>::infinity ())
+                {
+                  continue;
+                }
+              if (candidate.scoreSum / candidate.runs < bestScore - config.earlyStopMargin * std::fabs (bestScore))
+                {
+                  candidate.stopped = true;
+                  earlyStops++;
+                }
+            }
+        }
+
+      std::vector<double> scores (candidates.size ());
+      double generationBest = -std::numeric_limits<double>::infinity ();
+      double generationSum = 0;
+      uint32_t generationCount = 0;
+      for (uint32_t c = 0; c < candidates.size (); c++)
+        {
+          const tunerCandidate &candidate = candidates.at (c);
+          if (candidate.failed || candidate.runs == 0)
+            {
+              scores.at (c) = -std::numeric_limits<double>::infinity ();
+              failures++;
+              continue;
+            }
+          scores.at (c) = candidate.scoreSum / candidate.runs;
+          generationSum += scores.at (c);
+          generationCount++;
+          generationBest = std::max (generationBest, scores.at (c));
+          // only a candidate with all runs can become the best one
+          if (candidate.runs == config.runs && scores.at (c) > bestScore)
+            {
+              bestScore = scores.at (c);
+              best = candidate.point;
+              bestGeneration = g;
+            }
+        }
+
+      report << g << "," << simulations << "," << earlyStops << "," << failures << ","
+             << bestScore << "," << generationBest << ","
+             << (generationCount > 0 ? generationSum / generationCount : 0) << "," << es.GetSigma ();
+      for (uint32_t p = 0; p < n; p++)
+        {
+          report << "," << (best.empty () ? "" : FormatValue (config.space.at (p), best.at (p)));
+        }
+      report << "\n";
+      report.flush ();
+
+      es.Update (scores);
+      if (es.GetSigma () < 1e-4)
+        {
+          break;
+        }
+    }
+  report.close ();
+
+  if (best.empty ())
+    {
+      std::cerr << "No candidate finished all runs" << std::endl;
+      return 1;
+    }
+  std::ofstream output (outputFile.c_str ());
+  output << "# objective " << bestScore << " over " << config.runs << " runs, generation " << bestGeneration << "\n";
+  for (uint32_t p = 0; p < n; p++)
+    {
+      output << "default " << config.space.at (p).name << " \"" << FormatValue (config.space.at (p), best.at (p)) << "\"\n";
+    }
+  output.close ();
+  std::cout << "Best objective " << bestScore << ", written to " << outputFile << std::endl;
+  return 0;
+}
@@ -20,6 +20,8 @@
 #include "tcp-stream-helper.h"
 #include "ns3/tcp-stream-server.h"
 #include "ns3/tcp-stream-client.h"
+#include "ns3/tcp-stream-stats-sampler.h"
+#include "ns3/tcp-stream-churn-manager.h"
 #include "ns3/uinteger.h"
 #include "ns3/names.h"
 
@@ -76,6 +78,7 @@ TcpStreamServerHelper::InstallPriv (Ptr<Node> node) const
 TcpStreamClientHelper::TcpStreamClientHelper (Address address, uint16_t port)
 {
   m_factory.SetTypeId (TcpStreamClient::GetTypeId ());
+  m_churnFactory.SetTypeId (TcpStreamChurnManager::GetTypeId ());
   SetAttribute ("RemoteAddress", AddressValue (address));
   SetAttribute ("RemotePort", UintegerValue (port));
 }
@@ -83,6 +86,7 @@ TcpStreamClientHelper::TcpStreamClientHelper (Address address, uint16_t port)
 TcpStreamClientHelper::TcpStreamClientHelper (Ipv4Address address, uint16_t port)
 {
   m_factory.SetTypeId (TcpStreamClient::GetTypeId ());
+  m_churnFactory.SetTypeId (TcpStreamChurnManager::GetTypeId ());
   SetAttribute ("RemoteAddress", AddressValue (Address(address)));
   SetAttribute ("RemotePort", UintegerValue (port));
 }
@@ -90,6 +94,7 @@ TcpStreamClientHelper::TcpStreamClientHelper (Ipv4Address address, uint16_t port
 TcpStreamClientHelper::TcpStreamClientHelper (Ipv6Address address, uint16_t port)
 {
   m_factory.SetTypeId (TcpStreamClient::GetTypeId ());
+  m_churnFactory.SetTypeId (TcpStreamChurnManager::GetTypeId ());
   SetAttribute ("RemoteAddress", AddressValue (Address(address)));
   SetAttribute ("RemotePort", UintegerValue (port));
 }
@@ -101,17 +106,32 @@ TcpStreamClientHelper::SetAttribute (std::string name, const AttributeValue &val
 }
 
 ApplicationContainer
-TcpStreamClientHelper::Install (std::vector <std::pair <Ptr<Node>, std::string> > clients) const
+TcpStreamClientHelper::Install (std::vector <std::pair <Ptr<Node>, std::string> > clients, uint16_t firstClientId) const
 {
   ApplicationContainer apps;
   for (uint i = 0; i < clients.size (); i++)
     {
-      apps.Add (InstallPriv (clients.at (i).first, clients.at (i).second, i));
+      apps.Add (InstallPriv (clients.at (i).first, clients.at (i).second, firstClientId + i));
     }
 
   return apps;
 }
 
+void
+TcpStreamClientHelper::SetChurnAttribute (std::string name, const AttributeValue &value)
+{
+  m_churnFactory.Set (name, value);
+}
+
+Ptr<TcpStreamChurnManager>
+TcpStreamClientHelper::InstallChurn (NodeContainer nodes, std::string algo, Time start) const
+{
+  Ptr<TcpStreamChurnManager> manager = m_churnFactory.Create<TcpStreamChurnManager> ();
+  manager->Setup (m_factory, algo, nodes);
+  manager->Start (start);
+  return manager;
+}
+
 Ptr<Application>
 TcpStreamClientHelper::InstallPriv (Ptr<Node> node, std::string algo, uint16_t clientId) const
 {
@@ -122,4 +142,40 @@ TcpStreamClientHelper::InstallPriv (Ptr<Node> node, std::string algo, uint16_t c
   return app;
 }
 
+TcpStreamStatsHelper::TcpStreamStatsHelper ()
+{
+  m_factory.SetTypeId (TcpStreamStatsSampler::GetTypeId ());
+}
+
+void
+TcpStreamStatsHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+Ptr<TcpStreamStatsSampler>
+TcpStreamStatsHelper::Install (ApplicationContainer clients) const
+{
+  Ptr<TcpStreamStatsSampler> sampler = m_factory.Create<TcpStreamStatsSampler> ();
+  for (ApplicationContainer::Iterator i = clients.Begin (); i != clients.End (); ++i)
+    {
+      Ptr<TcpStreamClient> client = DynamicCast<TcpStreamClient> (*i);
+      if (client != 0)
+        {
+          sampler->AddClient (client);
+        }
+    }
+  sampler->Start ();
+  return sampler;
+}
+
+Ptr<TcpStreamStatsSampler>
+TcpStreamStatsHelper::Install (Ptr<TcpStreamChurnManager> manager) const
+{
+  Ptr<TcpStreamStatsSampler> sampler = m_factory.Create<TcpStreamStatsSampler> ();
+  sampler->FollowChurn (manager);
+  sampler->Start ();
+  return sampler;
+}
+
 } // namespace ns3
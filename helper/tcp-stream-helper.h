@@ -26,9 +26,12 @@
 #include "ns3/object-factory.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv6-address.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
+class TcpStreamChurnManager;
+
 /**
  * \ingroup TcpStream
  * \brief Create a server application which waits for input UDP packets
@@ -141,6 +144,7 @@ public:
 
   /**
    * \param clients the nodes with the name of the adaptation algorithm to be used
+   * \param firstClientId the client id of the first client, the following clients get consecutive ids
    *
    * Create one tcp stream client application on each of the input nodes and
    * instantiate an adaptation algorithm on each of the tcp stream client according
@@ -148,7 +152,27 @@ public:
    *
    * \returns the applications created, one application per input node.
    */
-  ApplicationContainer Install (std::vector <std::pair <Ptr<Node>, std::string> > clients) const;
+  ApplicationContainer Install (std::vector <std::pair <Ptr<Node>, std::string> > clients, uint16_t firstClientId = 0) const;
+
+  /**
+   * Record an attribute to be set in the TcpStreamChurnManager created by InstallChurn.
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetChurnAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \param nodes the node pool, every node hosts at most one client at a time
+   * \param algo the name of the adaptation algorithm to be used by all clients
+   * \param start the point in time when the arrival process starts
+   *
+   * Create a TcpStreamChurnManager, which installs a tcp stream client with the attributes set
+   * with SetAttribute on a free node for every arrival and disposes it when its session ended.
+   *
+   * \returns the churn manager
+   */
+  Ptr<TcpStreamChurnManager> InstallChurn (NodeContainer nodes, std::string algo, Time start) const;
 
 private:
   /**
@@ -163,6 +187,48 @@ private:
    */
   Ptr<Application> InstallPriv (Ptr<Node> node, std::string algo, uint16_t clientId) const;
   ObjectFactory m_factory; //!< Object factory.
+  ObjectFactory m_churnFactory; //!< Object factory for the churn manager.
+};
+
+class TcpStreamStatsSampler;
+
+/**
+ * \ingroup TcpStream
+ * \brief Create a TcpStreamStatsSampler which feeds the metrics of tcp stream clients into the stats framework
+ */
+class TcpStreamStatsHelper
+{
+public:
+  TcpStreamStatsHelper ();
+
+  /**
+   * Record an attribute to be set in the TcpStreamStatsSampler after it is is created.
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \param clients the tcp stream client applications to be sampled
+   *
+   * Create a TcpStreamStatsSampler for all clients in the container and start sampling.
+   *
+   * \returns the sampler
+   */
+  Ptr<TcpStreamStatsSampler> Install (ApplicationContainer clients) const;
+  /**
+   * \param manager the churn manager whose clients are to be sampled
+   *
+   * Create a TcpStreamStatsSampler for the clients of the churn manager and start sampling.
+   * Sampling continues until the last session of the churn manager ended.
+   *
+   * \returns the sampler
+   */
+  Ptr<TcpStreamStatsSampler> Install (Ptr<TcpStreamChurnManager> manager) const;
+
+private:
+  ObjectFactory m_factory; //!< Object factory.
 };
 
 } // namespace ns3
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-scenario-helper.h"
+#include "ns3/config-store.h"
+#include "ns3/config.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamScenarioHelper");
+
+TcpStreamScenarioHelper::TcpStreamScenarioHelper ()
+{
+}
+
+bool
+TcpStreamScenarioHelper::Load (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ifstream file (fileName.c_str ());
+  if (!file)
+    {
+      NS_LOG_ERROR ("Could not open scenario file " << fileName);
+      return false;
+    }
+  m_fileName = fileName;
+  m_groups.clear ();
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline (file, line))
+    {
+      lineNumber++;
+      std::istringstream buffer (line);
+      std::string type;
+      std::string name;
+      buffer >> type >> name;
+      if (type != "group")
+        {
+          continue;
+        }
+      std::string specification;
+      std::getline (buffer, specification);
+      // strip the blanks and quotes around the specification, as in the other RawText lines
+      size_t first = specification.find_first_not_of (" \t\"");
+      size_t last = specification.find_last_not_of (" \t\"\r");
+      specification = first == std::string::npos ? "" : specification.substr (first, last - first + 1);
+      clientGroup group;
+      if (!ParseGroup (name, specification, lineNumber, group))
+        {
+          return false;
+        }
+      m_groups.push_back (group);
+      if (GetNClients () > std::numeric_limits<uint16_t>::max ())
+        {
+          NS_LOG_ERROR ("Client group " << name << " in line " << lineNumber << " of " << m_fileName
+                        << " exceeds " << std::numeric_limits<uint16_t>::max () << " clients in total");
+          return false;
+        }
+    }
+
+  Config::SetDefault ("ns3::ConfigStore::Filename", StringValue (m_fileName));
+  Config::SetDefault ("ns3::ConfigStore::FileFormat", StringValue ("RawText"));
+  Config::SetDefault ("ns3::ConfigStore::Mode", StringValue ("Load"));
+  ConfigStore config;
+  config.ConfigureDefaults ();
+  return true;
+}
+
+bool
+TcpStreamScenarioHelper::ParseGroup (std::string name, std::string specification, uint32_t lineNumber, clientGroup &group) const
+{
+  group.name = name;
+  group.algorithm = "";
+  group.count = 0;
+  group.start = "2";
+  std::istringstream buffer (specification);
+  std::string item;
+  while (std::getline (buffer, item, ','))
+    {
+      size_t separator = item.find ('=');
+      if (separator == std::string::npos)
+        {
+          NS_LOG_ERROR ("Invalid entry " << item << " in client group " << name << " in line " << lineNumber << " of " << m_fileName);
+          return false;
+        }
+      std::string key = item.substr (0, separator);
+      std::string value = item.substr (separator + 1);
+      if (key == "algo")
+        {
+          group.algorithm = value;
+        }
+      else if (key == "count")
+        {
+          // client ids and NumberOfClients are 16 bit
+          std::istringstream number (value);
+          int64_t count;
+          char rest;
+          if (!(number >> count) || number >> rest || count < 0 || count > std::numeric_limits<uint16_t>::max ())
+            {
+              NS_LOG_ERROR ("Invalid client count " << value << " of client group " << name << " in line " << lineNumber << " of " << m_fileName);
+              return false;
+            }
+          group.count = count;
+        }
+      else if (key == "start")
+        {
+          group.start = value;
+        }
+      else if (key == "video")
+        {
+          group.attributes.push_back (std::make_pair (std::string ("SegmentSizeFilePath"), value));
+        }
+      else
+        {
+          group.attributes.push_back (std::make_pair (key, value));
+        }
+    }
+  if (group.algorithm.empty ())
+    {
+      NS_LOG_ERROR ("Client group " << name << " in line " << lineNumber << " of " << m_fileName << " has no algorithm");
+      return false;
+    }
+  return true;
+}
+
+uint32_t
+TcpStreamScenarioHelper::GetNClients () const
+{
+  uint32_t clients = 0;
+  for (uint32_t i = 0; i < m_groups.size (); i++)
+    {
+      clients += m_groups.at (i).count;
+    }
+  return clients;
+}
+
+void
+TcpStreamScenarioHelper::SetAlgorithm (std::string algorithm)
+{
+  NS_LOG_FUNCTION (this << algorithm);
+  for (uint32_t g = 0; g < m_groups.size (); g++)
+    {
+      m_groups.at (g).algorithm = algorithm;
+    }
+}
+
+ApplicationContainer
+TcpStreamScenarioHelper::Install (TcpStreamClientHelper clientHelper, NodeContainer nodes) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (nodes.GetN () < GetNClients (), "The scenario needs " << GetNClients () << " client nodes");
+  ApplicationContainer apps;
+  uint32_t nodeIndex = 0;
+  clientHelper.SetAttribute ("NumberOfClients", UintegerValue (GetNClients ()));
+  for (uint32_t g = 0; g < m_groups.size (); g++)
+    {
+      const clientGroup &group = m_groups.at (g);
+      TcpStreamClientHelper groupHelper = clientHelper;
+      for (uint32_t a = 0; a < group.attributes.size (); a++)
+        {
+          groupHelper.SetAttribute (group.attributes.at (a).first, StringValue (group.attributes.at (a).second));
+        }
+
+      // a plain number is a constant start time, anything else a random variable
+      Ptr<RandomVariableStream> start;
+      std::istringstream number (group.start);
+      double startTime;
+      if (!(number >> startTime) || !number.eof ())
+        {
+          ObjectFactory factory;
+          std::istringstream specification (group.start);
+          specification >> factory;
+          start = factory.Create<RandomVariableStream> ();
+        }
+
+      std::vector <std::pair <Ptr<Node>, std::string> > clients;
+      for (uint32_t i = 0; i < group.count; i++)
+        {
+          clients.push_back (std::make_pair (nodes.Get (nodeIndex + i), group.algorithm));
+        }
+      ApplicationContainer groupApps = groupHelper.Install (clients, nodeIndex);
+      for (uint32_t i = 0; i < groupApps.GetN (); i++)
+        {
+          groupApps.Get (i)->SetStartTime (Seconds (start ? start->GetValue () : startTime));
+        }
+      apps.Add (groupApps);
+      nodeIndex += group.count;
+    }
+  return apps;
+}
+
+void
+TcpStreamScenarioHelper::ConfigureAttributes () const
+{
+  NS_LOG_FUNCTION (this);
+  Config::SetDefault ("ns3::ConfigStore::Filename", StringValue (m_fileName));
+  Config::SetDefault ("ns3::ConfigStore::FileFormat", StringValue ("RawText"));
+  Config::SetDefault ("ns3::ConfigStore::Mode", StringValue ("Load"));
+  ConfigStore config;
+  config.ConfigureAttributes ();
+}
+
+std::string
+TcpStreamScenarioHelper::GetGroupName (uint16_t clientId) const
+{
+  uint32_t first = 0;
+  for (uint32_t g = 0; g < m_groups.size (); g++)
+    {
+      if (clientId < first + m_groups.at (g).count)
+        {
+          return m_groups.at (g).name;
+        }
+      first += m_groups.at (g).count;
+    }
+  return "";
+}
+
+} // namespace ns3
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_SCENARIO_HELPER_H
+#define TCP_STREAM_SCENARIO_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/application-container.h"
+#include "ns3/node-container.h"
+#include "tcp-stream-helper.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup TcpStream
+ * \brief Install heterogeneous groups of tcp stream clients described in a scenario file.
+ *
+ * The scenario file is a ConfigStore RawText file, whose default and global lines are applied by
+ * ConfigStore, plus one line per client group:
+ *
+ * \code
+ * default ns3::TcpStreamClient::SegmentDuration "2000000"
+ * group pandaViewers "algo=panda,count=10,start=ns3::UniformRandomVariable[Min=2|Max=5]"
+ * group bolaViewers "algo=bola,count=5,start=2,video=contrib/dash/segmentSizes.txt,TargetLatency=6000000"
+ * \endcode
+ *
+ * The keys algo (adaptation algorithm), count (number of clients), start (start time in seconds, a
+ * number or a random variable) and video (segment size file) are reserved, all other keys are
+ * attributes of ns3::TcpStreamClient that are set for all clients of the group. ConfigStore ignores the
+ * group lines, the value lines are applied by ConfigureAttributes () after the clients are installed.
+ * As the client ids are 16 bit, all groups together have at most 65535 clients.
+ */
+class TcpStreamScenarioHelper
+{
+public:
+  TcpStreamScenarioHelper ();
+
+  /**
+   * \brief Read the scenario file and apply its default and global lines.
+   *
+   * \param fileName the path of the scenario file
+   * \returns false if the file can't be read, a group line is invalid or the groups have more than 65535 clients in total
+   */
+  bool Load (std::string fileName);
+
+  /**
+   * \returns the total number of clients of all groups
+   */
+  uint32_t GetNClients () const;
+
+  /**
+   * \param algorithm the adaptation algorithm all groups use from now on, instead of their algo key
+   */
+  void SetAlgorithm (std::string algorithm);
+
+  /**
+   * \param clientHelper the helper with the attributes common to all clients, e.g. the server address
+   * \param nodes the client nodes, at least GetNClients (), assigned to the groups in file order
+   *
+   * Install the clients of all groups, the client ids are consecutive in file order.
+   *
+   * \returns the applications created
+   */
+  ApplicationContainer Install (TcpStreamClientHelper clientHelper, NodeContainer nodes) const;
+
+  /**
+   * \brief Apply the value lines of the scenario file, after the clients are installed.
+   */
+  void ConfigureAttributes () const;
+
+  /**
+   * \returns the name of the group of the client with the given id, empty if there is none
+   */
+  std::string GetGroupName (uint16_t clientId) const;
+
+private:
+  /**
+   * \brief A group of clients sharing algorithm, start time distribution and attributes.
+   */
+  struct clientGroup
+  {
+    std::string name; //!< the name of the group
+    std::string algorithm; //!< the adaptation algorithm
+    uint32_t count; //!< the number of clients
+    std::string start; //!< start time in seconds or a random variable
+    std::vector<std::pair<std::string, std::string> > attributes; //!< client attributes
+  };
+
+  /**
+   * \brief Parse the "key=value,..." specification of a group.
+   *
+   * \param lineNumber the line of the group in the scenario file, for error messages
+   */
+  bool ParseGroup (std::string name, std::string specification, uint32_t lineNumber, clientGroup &group) const;
+
+  std::string m_fileName; //!< the scenario file
+  std::vector<clientGroup> m_groups; //!< the client groups in file order
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_SCENARIO_HELPER_H */
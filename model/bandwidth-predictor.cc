@@ -0,0 +1,279 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bandwidth-predictor.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/log.h"
+#include "ns3/object-factory.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BandwidthPredictor");
+
+NS_OBJECT_ENSURE_REGISTERED (BandwidthPredictor);
+NS_OBJECT_ENSURE_REGISTERED (KalmanBandwidthPredictor);
+NS_OBJECT_ENSURE_REGISTERED (HoltBandwidthPredictor);
+NS_OBJECT_ENSURE_REGISTERED (HmmBandwidthPredictor);
+
+TypeId
+BandwidthPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BandwidthPredictor")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+  ;
+  return tid;
+}
+
+BandwidthPredictor::BandwidthPredictor ()
+  : m_errorSum (0),
+    m_predictions (0)
+{
+}
+
+Ptr<BandwidthPredictor>
+BandwidthPredictor::Create (std::string specification)
+{
+  if (specification.empty ())
+    {
+      return 0;
+    }
+  ObjectFactory factory;
+  std::istringstream buffer (specification);
+  buffer >> factory;
+  return factory.Create<BandwidthPredictor> ();
+}
+
+void
+BandwidthPredictor::Update (double throughput)
+{
+  if (!(throughput > 0))
+    {
+      return;
+    }
+  double prediction = Predict ();
+  if (prediction > 0)
+    {
+      m_errorSum += std::fabs (prediction - throughput) / throughput;
+      m_predictions++;
+      NS_LOG_INFO (GetInstanceTypeId ().GetName () << " predicted " << prediction << " measured " << throughput);
+    }
+  DoUpdate (throughput);
+}
+
+double
+BandwidthPredictor::GetMeanError () const
+{
+  return m_predictions == 0 ? 0 : m_errorSum / m_predictions;
+}
+
+TypeId
+KalmanBandwidthPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::KalmanBandwidthPredictor")
+    .SetParent<BandwidthPredictor> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<KalmanBandwidthPredictor> ()
+    .AddAttribute ("ProcessNoise",
+                   "The variance of the change of the natural logarithm of the throughput between two segments",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&KalmanBandwidthPredictor::m_processNoise),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("MeasurementNoise",
+                   "The variance of the natural logarithm of a throughput measurement",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&KalmanBandwidthPredictor::m_measurementNoise),
+                   MakeDoubleChecker<double> (0))
+  ;
+  return tid;
+}
+
+KalmanBandwidthPredictor::KalmanBandwidthPredictor ()
+  : m_estimate (0),
+    m_variance (-1)
+{
+}
+
+double
+KalmanBandwidthPredictor::Predict () const
+{
+  return m_variance < 0 ? 0 : std::exp (m_estimate);
+}
+
+void
+KalmanBandwidthPredictor::DoUpdate (double throughput)
+{
+  double measurement = std::log (throughput);
+  if (m_variance < 0)
+    {
+      m_estimate = measurement;
+      m_variance = m_measurementNoise;
+      return;
+    }
+  double variance = m_variance + m_processNoise;
+  double gain = variance / (variance + m_measurementNoise);
+  m_estimate += gain * (measurement - m_estimate);
+  m_variance = (1 - gain) * variance;
+}
+
+TypeId
+HoltBandwidthPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HoltBandwidthPredictor")
+    .SetParent<BandwidthPredictor> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<HoltBandwidthPredictor> ()
+    .AddAttribute ("Alpha",
+                   "The smoothing factor of the level",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&HoltBandwidthPredictor::m_alpha),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("Beta",
+                   "The smoothing factor of the trend",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&HoltBandwidthPredictor::m_beta),
+                   MakeDoubleChecker<double> (0, 1))
+  ;
+  return tid;
+}
+
+HoltBandwidthPredictor::HoltBandwidthPredictor ()
+  : m_level (0),
+    m_trend (0)
+{
+}
+
+double
+HoltBandwidthPredictor::Predict () const
+{
+  // a falling trend must not predict a throughput of 0 or below
+  return std::max (m_level + m_trend, m_level / 2);
+}
+
+void
+HoltBandwidthPredictor::DoUpdate (double throughput)
+{
+  if (m_level == 0)
+    {
+      m_level = throughput;
+      return;
+    }
+  double level = m_alpha * throughput + (1 - m_alpha) * (m_level + m_trend);
+  m_trend = m_beta * (level - m_level) + (1 - m_beta) * m_trend;
+  m_level = level;
+}
+
+TypeId
+HmmBandwidthPredictor::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HmmBandwidthPredictor")
+    .SetParent<BandwidthPredictor> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<HmmBandwidthPredictor> ()
+    .AddAttribute ("NumberOfStates",
+                   "The number of logarithmically spaced bandwidth levels",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&HmmBandwidthPredictor::m_states),
+                   MakeUintegerChecker<uint32_t> (2))
+    .AddAttribute ("MinBandwidth",
+                   "The lowest bandwidth level in bits per second",
+                   DoubleValue (1e5),
+                   MakeDoubleAccessor (&HmmBandwidthPredictor::m_minBandwidth),
+                   MakeDoubleChecker<double> (1))
+    .AddAttribute ("MaxBandwidth",
+                   "The highest bandwidth level in bits per second",
+                   DoubleValue (1e8),
+                   MakeDoubleAccessor (&HmmBandwidthPredictor::m_maxBandwidth),
+                   MakeDoubleChecker<double> (1))
+    .AddAttribute ("StayProbability",
+                   "The probability that the bandwidth level does not change between two segments",
+                   DoubleValue (0.9),
+                   MakeDoubleAccessor (&HmmBandwidthPredictor::m_stayProbability),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("Sigma",
+                   "The standard deviation of the natural logarithm of a measurement around its level",
+                   DoubleValue (0.3),
+                   MakeDoubleAccessor (&HmmBandwidthPredictor::m_sigma),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+HmmBandwidthPredictor::HmmBandwidthPredictor ()
+{
+}
+
+double
+HmmBandwidthPredictor::Predict () const
+{
+  if (m_belief.empty ())
+    {
+      return 0;
+    }
+  double jump = (1 - m_stayProbability) / (m_states - 1);
+  double logPrediction = 0;
+  for (uint32_t j = 0; j < m_states; j++)
+    {
+      double next = m_stayProbability * m_belief.at (j) + jump * (1 - m_belief.at (j));
+      logPrediction += next * m_logLevels.at (j);
+    }
+  return std::exp (logPrediction);
+}
+
+void
+HmmBandwidthPredictor::DoUpdate (double throughput)
+{
+  if (m_logLevels.empty ())
+    {
+      // the attributes are set after construction, so the levels are laid out on the first update
+      double logMin = std::log (m_minBandwidth);
+      double step = (std::log (m_maxBandwidth) - logMin) / (m_states - 1);
+      for (uint32_t j = 0; j < m_states; j++)
+        {
+          m_logLevels.push_back (logMin + j * step);
+        }
+      m_belief.assign (m_states, 1.0 / m_states);
+    }
+  // forward step: the jumps are uniform, so the prior of a level only depends on its own belief
+  double jump = (1 - m_stayProbability) / (m_states - 1);
+  double measurement = std::log (throughput);
+  double sum = 0;
+  for (uint32_t j = 0; j < m_states; j++)
+    {
+      double prior = m_stayProbability * m_belief.at (j) + jump * (1 - m_belief.at (j));
+      double distance = (measurement - m_logLevels.at (j)) / m_sigma;
+      m_belief.at (j) = prior * std::exp (-0.5 * distance * distance);
+      sum += m_belief.at (j);
+    }
+  if (sum <= 0)
+    {
+      // the measurement is far outside all levels, start over with the nearest one
+      uint32_t nearest = measurement <= m_logLevels.front () ? 0 : m_states - 1;
+      m_belief.assign (m_states, 0);
+      m_belief.at (nearest) = 1;
+      return;
+    }
+  for (uint32_t j = 0; j < m_states; j++)
+    {
+      m_belief.at (j) /= sum;
+    }
+}
+
+} // namespace ns3
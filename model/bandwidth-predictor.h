@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BANDWIDTH_PREDICTOR_H
+#define BANDWIDTH_PREDICTOR_H
+
+#include "ns3/object.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Base class of the bandwidth predictors adaptation algorithms can use.
+ *
+ * A predictor is fed the throughput of every downloaded segment and predicts the throughput of the
+ * next one. Every update costs O(1) in the number of segments. The relative error of every prediction
+ * against the throughput that was then measured is accumulated, see GetMeanError ().
+ */
+class BandwidthPredictor : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  BandwidthPredictor ();
+
+  /**
+   * \brief Create a predictor from its type name, optionally with attributes.
+   *
+   * \param specification e.g. "ns3::HoltBandwidthPredictor[Alpha=0.5|Beta=0.2]"
+   * \return the predictor, 0 if the specification is empty
+   */
+  static Ptr<BandwidthPredictor> Create (std::string specification);
+
+  /**
+   * \param throughput the measured throughput of the last segment in bits per second
+   */
+  void Update (double throughput);
+  /**
+   * \return the predicted throughput of the next segment in bits per second, 0 before the first update
+   */
+  virtual double Predict () const = 0;
+  /**
+   * \return the mean relative error |prediction - measurement| / measurement of all predictions so far
+   */
+  double GetMeanError () const;
+
+protected:
+  /**
+   * \brief Update the model with a new measurement.
+   * \param throughput the measured throughput in bits per second, > 0
+   */
+  virtual void DoUpdate (double throughput) = 0;
+
+private:
+  double m_errorSum; //!< sum of the relative errors of all predictions
+  int64_t m_predictions; //!< number of predictions compared with a measurement
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Kalman filter on the logarithm of the throughput, assuming a random walk.
+ */
+class KalmanBandwidthPredictor : public BandwidthPredictor
+{
+public:
+  static TypeId GetTypeId (void);
+  KalmanBandwidthPredictor ();
+  double Predict () const;
+
+protected:
+  void DoUpdate (double throughput);
+
+private:
+  double m_processNoise; //!< variance of the change of the log throughput between two segments
+  double m_measurementNoise; //!< variance of the log throughput measurement
+  double m_estimate; //!< estimated log throughput
+  double m_variance; //!< variance of m_estimate, negative before the first update
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Double exponential smoothing (Holt), following level and trend of the throughput.
+ */
+class HoltBandwidthPredictor : public BandwidthPredictor
+{
+public:
+  static TypeId GetTypeId (void);
+  HoltBandwidthPredictor ();
+  double Predict () const;
+
+protected:
+  void DoUpdate (double throughput);
+
+private:
+  double m_alpha; //!< smoothing factor of the level
+  double m_beta; //!< smoothing factor of the trend
+  double m_level; //!< smoothed throughput in bits per second, 0 before the first update
+  double m_trend; //!< smoothed change of the throughput per segment in bits per second
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Hidden Markov model over logarithmically spaced throughput levels.
+ *
+ * The hidden state is the bandwidth level, it stays with StayProbability and jumps to any other level
+ * otherwise; a measurement is log-normally distributed around the level. The belief is updated by the
+ * forward algorithm, in O(NumberOfStates) per segment thanks to the uniform jumps. The prediction is
+ * the geometric mean of the levels under the belief for the next segment.
+ */
+class HmmBandwidthPredictor : public BandwidthPredictor
+{
+public:
+  static TypeId GetTypeId (void);
+  HmmBandwidthPredictor ();
+  double Predict () const;
+
+protected:
+  void DoUpdate (double throughput);
+
+private:
+  uint32_t m_states; //!< number of bandwidth levels
+  double m_minBandwidth; //!< lowest level in bits per second
+  double m_maxBandwidth; //!< highest level in bits per second
+  double m_stayProbability; //!< probability that the level does not change between two segments
+  double m_sigma; //!< standard deviation of the log measurement around the level
+  std::vector<double> m_logLevels; //!< logarithm of every level, empty before the first update
+  std::vector<double> m_belief; //!< probability of every level after the last measurement
+};
+
+} // namespace ns3
+#endif /* BANDWIDTH_PREDICTOR_H */
@@ -0,0 +1,255 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bba.h"
+#include "ns3/integer.h"
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BbaAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED (Bba1Algorithm);
+NS_OBJECT_ENSURE_REGISTERED (Bba2Algorithm);
+
+TypeId
+Bba1Algorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Bba1Algorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("Reservoir",
+                   "The buffer level in microseconds below which the lowest representation is requested",
+                   IntegerValue (5000000),
+                   MakeIntegerAccessor (&Bba1Algorithm::m_reservoir),
+                   MakeIntegerChecker<int64_t> (0))
+    .AddAttribute ("Cushion",
+                   "The size in microseconds of the buffer range above the reservoir over which the map rises to the highest representation",
+                   IntegerValue (20000000),
+                   MakeIntegerAccessor (&Bba1Algorithm::m_cushion),
+                   MakeIntegerChecker<int64_t> (0))
+    .AddAttribute ("MaxBuffer",
+                   "The buffer level in microseconds above which the next request is delayed",
+                   IntegerValue (30000000),
+                   MakeIntegerAccessor (&Bba1Algorithm::m_maxBuffer),
+                   MakeIntegerChecker<int64_t> (0))
+  ;
+  return tid;
+}
+
+Bba1Algorithm::Bba1Algorithm (  const videoData &videoData,
+                                const playbackData & playbackData,
+                                const bufferData & bufferData,
+                                const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1),
+  m_lastRepIndex (0)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+}
+
+void
+Bba1Algorithm::DoConstruct (void)
+{
+  double lowest = m_videoData.averageBitrate.front ();
+  double highest = m_videoData.averageBitrate.back ();
+  m_rateMap.clear ();
+  for (int64_t i = 0; i <= m_highestRepIndex; i++)
+    {
+      double share = highest > lowest ? (m_videoData.averageBitrate.at (i) - lowest) / (highest - lowest) : 0;
+      m_rateMap.push_back (m_reservoir + (int64_t)(share * m_cushion));
+    }
+}
+
+algorithmReply
+Bba1Algorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  if (segmentCounter == 0)
+    {
+      m_lastRepIndex = 0;
+      return MakeReply (timeNow, 0, 0, 0);
+    }
+  int64_t bufferNow = GetBufferNow (timeNow);
+  int64_t nextRepIndex = SelectRep (bufferNow, m_playbackData.contentIndex.at (segmentCounter));
+  int64_t decisionCase = nextRepIndex > m_lastRepIndex ? 2 : (nextRepIndex < m_lastRepIndex ? 3 : 1);
+  m_lastRepIndex = nextRepIndex;
+  return MakeReply (timeNow, bufferNow, nextRepIndex, decisionCase);
+}
+
+int64_t
+Bba1Algorithm::GetThreshold (int64_t repIndex, int64_t segmentIndex) const
+{
+  return m_rateMap.at (repIndex);
+}
+
+int64_t
+Bba1Algorithm::SelectRep (int64_t bufferNow, int64_t segmentIndex) const
+{
+  if (bufferNow < m_reservoir)
+    {
+      return 0;
+    }
+  // the map passed the next higher representation: take the highest one below the map
+  if (m_lastRepIndex < m_highestRepIndex && GetThreshold (m_lastRepIndex + 1, segmentIndex) <= bufferNow)
+    {
+      int64_t repIndex = m_highestRepIndex;
+      while (repIndex > 0 && GetThreshold (repIndex, segmentIndex) > bufferNow)
+        {
+          repIndex--;
+        }
+      return repIndex;
+    }
+  // the map fell below the next lower representation: take the lowest one above the map
+  if (m_lastRepIndex > 0 && GetThreshold (m_lastRepIndex - 1, segmentIndex) >= bufferNow)
+    {
+      int64_t repIndex = 0;
+      while (repIndex < m_highestRepIndex && GetThreshold (repIndex, segmentIndex) <= bufferNow)
+        {
+          repIndex++;
+        }
+      return repIndex;
+    }
+  return m_lastRepIndex;
+}
+
+algorithmReply
+Bba1Algorithm::MakeReply (int64_t timeNow, int64_t bufferNow, int64_t nextRepIndex, int64_t decisionCase)
+{
+  algorithmReply answer;
+  answer.nextRepIndex = nextRepIndex;
+  answer.nextDownloadDelay = 0;
+  answer.delayDecisionCase = 0;
+  if (bufferNow > m_maxBuffer)
+    {
+      answer.nextDownloadDelay = bufferNow - m_maxBuffer;
+      answer.delayDecisionCase = 1;
+    }
+  answer.decisionTime = timeNow;
+  answer.decisionCase = decisionCase;
+  answer.bandwidthEstimate = 0;
+  return answer;
+}
+
+TypeId
+Bba2Algorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Bba2Algorithm")
+    .SetParent<Bba1Algorithm> ()
+    .SetGroupName ("Applications")
+  ;
+  return tid;
+}
+
+Bba2Algorithm::Bba2Algorithm (  const videoData &videoData,
+                                const playbackData & playbackData,
+                                const bufferData & bufferData,
+                                const throughputData & throughput) :
+  Bba1Algorithm (videoData, playbackData, bufferData, throughput),
+  m_chunkMap (0),
+  m_startup (true)
+{
+  NS_LOG_INFO (this);
+}
+
+void
+Bba2Algorithm::DoConstruct (void)
+{
+  Bba1Algorithm::DoConstruct ();
+  m_chunkMap = GetChunkMap ();
+}
+
+const std::vector<std::vector<int64_t> > *
+Bba2Algorithm::GetChunkMap () const
+{
+  // the video data is shared by all clients playing the title (see TcpStreamCatalog), and so is its chunk map,
+  // as long as they use the same reservoir and cushion
+  typedef std::pair<const videoData *, std::pair<int64_t, int64_t> > chunkMapKey;
+  static std::map<chunkMapKey, std::vector<std::vector<int64_t> > > chunkMaps;
+  chunkMapKey key = std::make_pair (&m_videoData, std::make_pair (m_reservoir, m_cushion));
+  std::map<chunkMapKey, std::vector<std::vector<int64_t> > >::iterator it = chunkMaps.find (key);
+  if (it != chunkMaps.end ())
+    {
+      return &it->second;
+    }
+
+  // the chunk sizes range from the mean segment size of the lowest to that of the highest representation
+  const std::vector<int64_t> &lowest = m_videoData.segmentSize.front ();
+  const std::vector<int64_t> &highest = m_videoData.segmentSize.back ();
+  double minChunk = std::accumulate (lowest.begin (), lowest.end (), 0.0) / lowest.size ();
+  double maxChunk = std::accumulate (highest.begin (), highest.end (), 0.0) / highest.size ();
+  std::vector<std::vector<int64_t> > &chunkMap = chunkMaps[key];
+  chunkMap.resize (m_videoData.segmentSize.size ());
+  for (size_t i = 0; i < m_videoData.segmentSize.size (); i++)
+    {
+      const std::vector<int64_t> &sizes = m_videoData.segmentSize.at (i);
+      chunkMap.at (i).reserve (sizes.size ());
+      for (size_t j = 0; j < sizes.size (); j++)
+        {
+          double share = maxChunk > minChunk ? (sizes.at (j) - minChunk) / (maxChunk - minChunk) : 0;
+          share = std::min (std::max (share, 0.0), 1.0);
+          chunkMap.at (i).push_back (m_reservoir + (int64_t)(share * m_cushion));
+        }
+    }
+  return &chunkMap;
+}
+
+int64_t
+Bba2Algorithm::GetThreshold (int64_t repIndex, int64_t segmentIndex) const
+{
+  return m_chunkMap->at (repIndex).at (segmentIndex);
+}
+
+algorithmReply
+Bba2Algorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  if (segmentCounter == 0)
+    {
+      m_lastRepIndex = 0;
+      m_startup = true;
+      return MakeReply (timeNow, 0, 0, 0);
+    }
+  int64_t bufferNow = GetBufferNow (timeNow);
+  int64_t nextRepIndex = SelectRep (bufferNow, m_playbackData.contentIndex.at (segmentCounter));
+  int64_t decisionCase = nextRepIndex > m_lastRepIndex ? 2 : (nextRepIndex < m_lastRepIndex ? 3 : 1);
+
+  if (m_startup)
+    {
+      int64_t segmentDuration = m_videoData.segmentDuration;
+      int64_t bufferGain = segmentDuration - (m_throughput.transmissionEnd.back () - m_throughput.transmissionRequested.back ());
+      double fill = std::min (1.0, bufferNow / (double)(m_reservoir + m_cushion));
+      int64_t startupRepIndex = m_lastRepIndex;
+      if (startupRepIndex < m_highestRepIndex && bufferGain > (0.875 - 0.375 * fill) * segmentDuration)
+        {
+          startupRepIndex++;
+        }
+      if (bufferGain < 0 || nextRepIndex >= startupRepIndex)
+        {
+          m_startup = false;
+        }
+      else
+        {
+          nextRepIndex = startupRepIndex;
+          decisionCase = 4;
+        }
+    }
+
+  m_lastRepIndex = nextRepIndex;
+  return MakeReply (timeNow, bufferNow, nextRepIndex, decisionCase);
+}
+} // namespace ns3
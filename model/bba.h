@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BBA_ALGORITHM_H
+#define BBA_ALGORITHM_H
+
+#include "tcp-stream-adaptation-algorithm.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Implementation of the buffer based BBA-1 adaptation algorithm (Huang et al., SIGCOMM 2014)
+ *
+ * The rate map is the lowest bitrate below the reservoir, the highest one above reservoir plus cushion
+ * and linear in between. It is stored as the buffer level from which on every representation is the
+ * rate map's choice, so a decision is a lookup in that table. The representation only changes if the
+ * rate map passes the bitrate of a neighbouring representation, which avoids oscillations between two
+ * levels. No throughput estimate is used at all. The reservoir, the cushion and the maximum buffer are the
+ * attributes Reservoir, Cushion and MaxBuffer, which BBA-2 shares.
+ */
+class Bba1Algorithm : public AdaptationAlgorithm
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Bba1Algorithm (  const videoData &videoData,
+                   const playbackData & playbackData,
+                   const bufferData & bufferData,
+                   const throughputData & throughput);
+
+  virtual algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+protected:
+  /**
+   * \brief Build the rate map from the attribute values.
+   */
+  virtual void DoConstruct (void);
+  /**
+   * \return the buffer level in microseconds from which on representation repIndex is chosen for the segment
+   */
+  virtual int64_t GetThreshold (int64_t repIndex, int64_t segmentIndex) const;
+  /**
+   * \brief Apply the map with hysteresis.
+   *
+   * \param bufferNow the current buffer level in microseconds
+   * \param segmentIndex the index of the segment in the video file
+   * \return the representation index of the next segment
+   */
+  int64_t SelectRep (int64_t bufferNow, int64_t segmentIndex) const;
+  /**
+   * \brief Fill the reply, delaying the next request while the buffer is above m_maxBuffer.
+   */
+  algorithmReply MakeReply (int64_t timeNow, int64_t bufferNow, int64_t nextRepIndex, int64_t decisionCase);
+
+  const int64_t m_highestRepIndex;
+  int64_t m_reservoir; //!< buffer level in microseconds below which the lowest representation is chosen
+  int64_t m_cushion; //!< size in microseconds of the buffer range the rate map increases over
+  int64_t m_maxBuffer; //!< buffer level in microseconds the next request waits for to be undercut
+  int64_t m_lastRepIndex;
+
+private:
+  std::vector<int64_t> m_rateMap; //!< buffer level in microseconds from which on every representation is chosen
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Implementation of the buffer based BBA-2 adaptation algorithm
+ *
+ * Same as BBA-1, but the map is a chunk map: it maps the buffer level to a segment size, and the sizes of
+ * the actual segments of every representation are compared with it, so segments much larger than the
+ * average bitrate suggests are requested in a lower representation. The thresholds of all segments of a
+ * title are computed once per process for every reservoir and cushion, and shared by all clients playing it
+ * with them. In the startup phase the representation is stepped up whenever a segment was downloaded clearly
+ * faster than it plays, from 8 times faster at an empty buffer down to 2 times faster at the end of the
+ * cushion, until the chunk map chooses a higher representation or the buffer shrinks.
+ */
+class Bba2Algorithm : public Bba1Algorithm
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Bba2Algorithm (  const videoData &videoData,
+                   const playbackData & playbackData,
+                   const bufferData & bufferData,
+                   const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+protected:
+  /**
+   * \brief Build the rate map and look up the chunk map of the title.
+   */
+  void DoConstruct (void);
+  int64_t GetThreshold (int64_t repIndex, int64_t segmentIndex) const;
+
+private:
+  /**
+   * \return the chunk map thresholds of the title, computed on first use
+   */
+  const std::vector<std::vector<int64_t> > * GetChunkMap () const;
+
+  const std::vector<std::vector<int64_t> > *m_chunkMap; //!< [representation][segment] buffer level in microseconds from which on the segment is requested in that representation
+  bool m_startup; //!< true while the startup phase lasts
+};
+} // namespace ns3
+#endif /* BBA_ALGORITHM_H */
@@ -12,12 +12,37 @@ namespace ns3 {
   NS_LOG_COMPONENT_DEFINE ("BolaAlgo");
   NS_OBJECT_ENSURE_REGISTERED (BolaAlgo);
 
-  BolaAlgo::BolaAlgo (const videoData &videoData, const playbackData & playbackData, const bufferData & bufferData, const throughputData & throughput) : 
-    AdaptationAlgorithm (videoData, playbackData, bufferData, throughput), 
-    m_highestRepIndex (videoData.averageBitrate.size () - 1)
+  BolaAlgo::BolaAlgo (const videoData &videoData, const playbackData & playbackData, const bufferData & bufferData, const throughputData & throughput, bool dynamic) :
+    AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+    m_highestRepIndex (videoData.averageBitrate.size () - 1),
+    m_lastRepIndex (0),
+    m_dynamic (dynamic),
+    m_useBola (!dynamic),
+    m_placeholderBuffer (0),
+    m_throughputSegments (0),
+    m_sumBytes (0),
+    m_sumTime (0),
+    segDuration (videoData.segmentDuration)
  {
     NS_LOG_INFO (this);
     NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+
+    // everything derived from the ladder is computed once here, for any number of representations
+    for(int i=0; i<=m_highestRepIndex; i++) {
+      bitrates.push_back(m_videoData.averageBitrate.at(i)/1000);
+    }
+
+    for(int i=0; i<=m_highestRepIndex; i++) {
+      utilities.push_back(log(bitrates[i]) - log(bitrates[0]) + 1);
+    }
+
+    calculateBolaParameters();
+
+    for(int i=0; i<=m_highestRepIndex; i++) {
+      maxBufferLevels.push_back(Vp * (utilities[i] + gp));
+    }
+
+    state = BOLA_STATE_STARTUP;
   }
 
   algorithmReply BolaAlgo::GetNextRep ( const int64_t segmentCounter, int64_t clientId) {
@@ -30,8 +55,6 @@ namespace ns3 {
 
     if(segmentCounter == 0) {
 
-        segDuration = m_videoData.segmentDuration;
-
         m_lastRepIndex = nextRepIndex;
         algorithmReply answer;
         answer.nextRepIndex = nextRepIndex;
@@ -39,71 +62,66 @@ namespace ns3 {
         answer.decisionTime = timeNow;
         answer.decisionCase = decisionCase;
         answer.delayDecisionCase = delayDecision;
-        answer.bandwidthEstimate = 0;  
-        answer.bufferEstimate = 0;
-        answer.secondBandwidthEstimate = 0;
+        answer.bandwidthEstimate = 0;
         return answer;
     }
 
-    if(state == BOLA_STATE_INIT) {
-      
-      for(int i=0; i<=m_highestRepIndex; i++) {
-        bitrates[i] = m_videoData.averageBitrate.at(i)/1000;
-      }
-      
-      for(int i=0; i<=m_highestRepIndex; i++) {
-        utilities[i] = log(bitrates[i]);
-      }
-      
-      for(int i=0; i<=m_highestRepIndex; i++) {
-        utilities[i] = utilities[i] - utilities[0] + 1;
-      }
+    double throughput = AverageSegmentThroughput(segmentCounter)/1000;
+    double bufferLevel = std::max(0.0, m_bufferData.bufferLevelNew.back ()/ (double)1000000 - (timeNow - m_bufferData.timeNow.back())/ (double)1000000);
+    updatePlaceholderBuffer(timeNow, bufferLevel);
 
-      calculateBolaParameters();
+    if(m_dynamic) {
+        // dash.js abrDynamic: BOLA above the stable buffer time, the throughput rule below half of it
+        m_useBola = bufferLevel > (m_useBola ? 0.5 * bufferTime : bufferTime);
+    }
 
-      state = BOLA_STATE_STARTUP;
+    if(!m_useBola) {
 
-    }
+        nextRepIndex = getQualityForBitrate(throughput * THROUGHPUT_SAFETY_FACTOR);
+        decisionCase = 2;
 
-    double throughput = AverageSegmentThroughput(segmentCounter)/1000;
-    
-    
-    algorithmReply answer;
-    answer.secondBandwidthEstimate = 0;
-    if(state == BOLA_STATE_STARTUP) {
+    } else if(state == BOLA_STATE_STARTUP) {
 
         int quality = getQualityForBitrate(throughput);
 
         nextRepIndex = quality;
 
-        double bufferLevel = (m_bufferData.bufferLevelNew.back ()/ (double)1000000 - (timeNow - m_bufferData.timeNow.back())/ (double)1000000);
-        answer.bufferEstimate = bufferLevel;
-
         if (bufferLevel >= (segDuration/1000000)) {
             state = BOLA_STATE_STEADY;
         }
 
     } else if(state == BOLA_STATE_STEADY) {
 
-        double bufferLevel = (m_bufferData.bufferLevelNew.back ()/ (double)1000000 - (timeNow - m_bufferData.timeNow.back())/ (double)1000000);
-        answer.bufferEstimate = bufferLevel;
-        int quality = getQualityFromBufferLevel(bufferLevel);
+        // BOLA-E: the placeholder buffer counts as buffer for the decision
+        double effectiveBuffer = bufferLevel + m_placeholderBuffer;
+        int quality = getQualityFromBufferLevel(effectiveBuffer);
 
         int qualityForThroughput = getQualityForBitrate(throughput);
-      
+
         if (quality > m_lastRepIndex && quality > qualityForThroughput) {
             quality = std::max(qualityForThroughput, (int)m_lastRepIndex);
         }
 
-        double delayS = std::max((double)0, (double)bufferLevel - maxBufferLevelForQuality(quality));
+        // a delay is taken from the placeholder buffer first
+        double delayS = std::max((double)0, effectiveBuffer - maxBufferLevelForQuality(quality));
+        if (delayS <= m_placeholderBuffer) {
+            m_placeholderBuffer -= delayS;
+            delayS = 0;
+        } else {
+            delayS -= m_placeholderBuffer;
+            m_placeholderBuffer = 0;
+            delayDecision = 1;
+        }
 
         nextRepIndex = quality;
-        bDelay = delayS;
+        bDelay = (int64_t)(delayS * 1000000);
+        decisionCase = 1;
 
     }
 
 
     m_lastRepIndex = nextRepIndex;
+    algorithmReply answer;
     answer.nextRepIndex = nextRepIndex;
     answer.nextDownloadDelay = bDelay;
     answer.decisionTime = timeNow;
@@ -115,23 +133,18 @@ namespace ns3 {
 
   double BolaAlgo::AverageSegmentThroughput (int64_t currentSegment) {
 
-    double lengthOfInterval;
-    double sumThroughput = 0.0;
-    double transmissionTime = 0.0;
-
-    int count = 0;
-    for(int index=currentSegment-1; index>=0; index--)
+    // the sums over all downloaded segments are kept up to date instead of being recomputed on every decision
+    for(; m_throughputSegments < currentSegment; m_throughputSegments++)
     {
-      lengthOfInterval = (m_throughput.transmissionEnd.at (index) - m_throughput.transmissionStart.at (index))/(double)1000000;
-      sumThroughput += m_throughput.bytesReceived.at(index);
-      transmissionTime += lengthOfInterval;
-      count++;}
+      m_sumTime += (m_throughput.transmissionEnd.at (m_throughputSegments) - m_throughput.transmissionStart.at (m_throughputSegments))/(double)1000000;
+      m_sumBytes += m_throughput.bytesReceived.at(m_throughputSegments);
+    }
 
-    return (sumThroughput*8 / (double)transmissionTime);
+    return (m_sumBytes*8 / (double)m_sumTime);
   }
 
   void BolaAlgo::calculateBolaParameters() {
-      
+
     int highestUtilityIndex = 0;
     for(int i=0; i<=m_highestRepIndex; i++) {
       if(utilities[i] > utilities[highestUtilityIndex]) {
@@ -139,13 +152,13 @@ namespace ns3 {
       }
     }
 
-    double bufferTime = std::max(STABLE_BUFFER, MINIMUM_BUFFER_S + MINIMUM_BUFFER_PER_BITRATE_LEVEL_S * (int)(m_highestRepIndex+1));
+    bufferTime = std::max(STABLE_BUFFER, MINIMUM_BUFFER_S + MINIMUM_BUFFER_PER_BITRATE_LEVEL_S * (int)(m_highestRepIndex+1));
 
     gp = (utilities[highestUtilityIndex] - 1) / (bufferTime / MINIMUM_BUFFER_S - 1);
     Vp = MINIMUM_BUFFER_S / gp;
 
   }
-  
+
   int BolaAlgo::getQualityFromBufferLevel(double bufferLevel) {
     int quality = -1;
     double score = 0;
@@ -160,7 +173,7 @@ namespace ns3 {
   }
 
   double BolaAlgo::maxBufferLevelForQuality(int quality) {
-    return Vp * (utilities[quality] + gp);
+    return maxBufferLevels[quality];
   }
 
   double BolaAlgo::minBufferLevelForQuality(int quality) {
@@ -179,10 +192,10 @@ namespace ns3 {
     }
     return min;
   }
-  
+
   int BolaAlgo::getQualityForBitrate(double bitrate) {
     int quality = m_highestRepIndex;
-    for(int i=0; i<=m_highestRepIndex; i++) {   
+    for(int i=0; i<=m_highestRepIndex; i++) {
       if(bitrate <= bitrates[i]) {
         quality = std::max(0, i - 1);
         break;
@@ -191,4 +204,15 @@ namespace ns3 {
     if(std::isnan(bitrate)) { quality = 0; }
     return quality;
   }
+
+  void BolaAlgo::updatePlaceholderBuffer(int64_t timeNow, double bufferLevel) {
+    if (bufferLevel <= 0) {
+      // the buffer ran dry, there is nothing the placeholder could stand in for
+      m_placeholderBuffer = 0;
+      return;
+    }
+    m_placeholderBuffer += std::max(0.0, (timeNow - m_throughput.transmissionEnd.back())/(double)1000000);
+    // never more than needed to reach the highest representation
+    m_placeholderBuffer = std::min(m_placeholderBuffer, std::max(0.0, maxBufferLevels[m_highestRepIndex] - bufferLevel));
+  }
 } // namespace ns3
@@ -5,13 +5,24 @@
 
 namespace ns3 {
 
+/**
+ * \ingroup tcpStream
+ * \brief Implementation of the BOLA adaptation algorithm, based on the dash.js BolaRule
+ *
+ * The utilities, bitrates and BOLA parameters are derived from the ladder once, when the algorithm
+ * is created, for any number of representations. Time spent waiting between downloads is kept in a
+ * placeholder buffer (BOLA-E), so that the algorithm's own delays don't lower the buffer level BOLA
+ * decides on. In dynamic mode (dash.js abrDynamic) the throughput rule decides while the buffer is low,
+ * BOLA takes over once the buffer reaches the stable buffer time and hands back below half of it.
+ */
 class BolaAlgo : public AdaptationAlgorithm
 {
 public:
   BolaAlgo (  const videoData &videoData,
                       const playbackData & playbackData,
                       const bufferData & bufferData,
-                      const throughputData & throughput);
+                      const throughputData & throughput,
+                      bool dynamic = false);
 
   algorithmReply GetNextRep ( const int64_t segmentCounter, int64_t clientId);
 
@@ -19,28 +30,41 @@ private:
 
   const int64_t m_highestRepIndex;
   int64_t m_lastRepIndex;
-  
-  const int BOLA_STATE_INIT = -1;
+
   const int BOLA_STATE_STARTUP = 0;
   const int BOLA_STATE_STEADY = 1;
-  int state = -1;
+  int state = 0;
   const int MINIMUM_BUFFER_S = 1;
   const int MINIMUM_BUFFER_PER_BITRATE_LEVEL_S = 1;
   const int STABLE_BUFFER = 2;
-  
+  const double THROUGHPUT_SAFETY_FACTOR = 0.9;
+
   double Vp = 0;
   double gp = 0;
-  
-  double utilities [10];
-  double bitrates [10];
-  
+  double bufferTime = 0; //!< the stable buffer time in seconds BOLA's parameters are derived from
+
+  std::vector<double> utilities; //!< utility of every representation
+  std::vector<double> bitrates; //!< bitrate of every representation in kbit/s
+  std::vector<double> maxBufferLevels; //!< buffer level in seconds above which a representation is not chosen
+
+  const bool m_dynamic; //!< true to switch between the throughput rule and BOLA by buffer level
+  bool m_useBola; //!< true while BOLA decides in dynamic mode
+  double m_placeholderBuffer; //!< virtual buffer in seconds for the time waited between downloads
+  int64_t m_throughputSegments; //!< number of segments summed up in m_sumBytes and m_sumTime
+  double m_sumBytes; //!< bytes of all downloaded segments
+  double m_sumTime; //!< transmission time in seconds of all downloaded segments
+
   double AverageSegmentThroughput (int64_t currentSegment);
   void calculateBolaParameters();
   int getQualityFromBufferLevel(double bufferLevel);
   double maxBufferLevelForQuality(int quality);
   double minBufferLevelForQuality(int quality);
   int getQualityForBitrate(double bitrate);
-  
+  /**
+   * \brief Add the time since the last download ended to the placeholder buffer, as dash.js BOLA-E does.
+   */
+  void updatePlaceholderBuffer(int64_t timeNow, double bufferLevel);
+
   uint64_t segDuration;
 };
 } // namespace ns3
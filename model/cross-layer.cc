@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cross-layer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CrossLayerAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED (CrossLayerAlgorithm);
+
+CrossLayerAlgorithm::CrossLayerAlgorithm (  const videoData &videoData,
+                                            const playbackData & playbackData,
+                                            const bufferData & bufferData,
+                                            const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1),
+  m_safety (0.9),
+  m_lowBuffer (2 * videoData.segmentDuration),
+  m_lastRepIndex (0)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+}
+
+algorithmReply
+CrossLayerAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  algorithmReply answer;
+  answer.decisionTime = timeNow;
+  answer.nextDownloadDelay = 0;
+  answer.delayDecisionCase = 0;
+
+  if (segmentCounter == 0 || m_throughput.transmissionEnd.empty ())
+    {
+      m_lastRepIndex = 0;
+      answer.nextRepIndex = 0;
+      answer.decisionCase = 0;
+      answer.bandwidthEstimate = 0;
+      return answer;
+    }
+
+  double estimate = TransportEstimate (timeNow);
+  answer.decisionCase = 1;
+  if (estimate <= 0)
+    {
+      estimate = SegmentEstimate ();
+      answer.decisionCase = 2;
+    }
+
+  int64_t nextRepIndex = 0;
+  while (nextRepIndex < m_highestRepIndex
+         && m_videoData.averageBitrate.at (nextRepIndex + 1) <= m_safety * estimate)
+    {
+      nextRepIndex++;
+    }
+  int64_t bufferNow = GetBufferNow (timeNow);
+  if (nextRepIndex > m_lastRepIndex + 1 && bufferNow < m_lowBuffer)
+    {
+      nextRepIndex = m_lastRepIndex + 1;
+      answer.decisionCase = 3;
+    }
+
+  m_lastRepIndex = nextRepIndex;
+  answer.nextRepIndex = nextRepIndex;
+  answer.bandwidthEstimate = estimate / (double)1000000;
+  return answer;
+}
+
+double
+CrossLayerAlgorithm::TransportEstimate (int64_t timeNow) const
+{
+  if (m_transport == 0 || m_transport->deliveryRate.empty ())
+    {
+      return 0;
+    }
+  // harmonic mean of the samples of the last segment duration, at least the most recent one
+  double inverseSum = 0;
+  int64_t samples = 0;
+  for (size_t i = m_transport->deliveryRate.size (); i-- > 0; )
+    {
+      if (samples > 0 && m_transport->deliveryRateTime.at (i) < timeNow - m_videoData.segmentDuration)
+        {
+          break;
+        }
+      if (m_transport->deliveryRate.at (i) > 0)
+        {
+          inverseSum += 1.0 / m_transport->deliveryRate.at (i);
+          samples++;
+        }
+    }
+  if (samples == 0)
+    {
+      return 0;
+    }
+  double estimate = samples / inverseSum;
+  if (m_transport->congestionWindow > 0 && m_transport->smoothedRtt > 0)
+    {
+      double windowRate = m_transport->congestionWindow * 8 / (m_transport->smoothedRtt / 1000000.0);
+      estimate = std::min (estimate, windowRate);
+    }
+  return estimate;
+}
+
+double
+CrossLayerAlgorithm::SegmentEstimate () const
+{
+  double transmissionTime = (m_throughput.transmissionEnd.back () - m_throughput.transmissionRequested.back ()) / (double)1000000;
+  if (transmissionTime <= 0)
+    {
+      return 0;
+    }
+  return m_throughput.bytesReceived.back () * 8 / transmissionTime;
+}
+} // namespace ns3
@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CROSS_LAYER_ALGORITHM_H
+#define CROSS_LAYER_ALGORITHM_H
+
+#include "tcp-stream-adaptation-algorithm.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Rate based adaptation with a bandwidth estimate from the TCP state of the connection
+ *
+ * The bandwidth is estimated by the harmonic mean of the delivery rate samples of the last segment
+ * duration, bounded by the rate the congestion window allows (cwnd / smoothed RTT), so that a window
+ * reduction is seen at the next decision, not one segment later. Without transport data, e.g. if the
+ * server does not provide it, the throughput of the last segment is used. The highest representation
+ * below a safety share of the estimate is chosen, upswitches are limited to one level while the buffer
+ * is low.
+ */
+class CrossLayerAlgorithm : public AdaptationAlgorithm
+{
+public:
+  CrossLayerAlgorithm (  const videoData &videoData,
+                         const playbackData & playbackData,
+                         const bufferData & bufferData,
+                         const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+private:
+  /**
+   * \return the bandwidth estimate in bits per second from the transport data, 0 if there are no recent samples
+   */
+  double TransportEstimate (int64_t timeNow) const;
+  /**
+   * \return the throughput of the last downloaded segment in bits per second
+   */
+  double SegmentEstimate () const;
+
+  const int64_t m_highestRepIndex;
+  const double m_safety; //!< share of the bandwidth estimate the chosen bitrate may use
+  const int64_t m_lowBuffer; //!< buffer level in microseconds below which only one level up is allowed
+  int64_t m_lastRepIndex;
+};
+} // namespace ns3
+#endif /* CROSS_LAYER_ALGORITHM_H */
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "elastic.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ElasticAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED (ElasticAlgorithm);
+
+TypeId
+ElasticAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ElasticAlgorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("TargetBuffer",
+                   "The buffer level in microseconds the controller drives the buffer to",
+                   UintegerValue (15000000),
+                   MakeUintegerAccessor (&ElasticAlgorithm::m_targetBuffer),
+                   MakeUintegerChecker<uint64_t> (1))
+    .AddAttribute ("Kp",
+                   "The proportional gain per second of buffer level",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&ElasticAlgorithm::m_kp),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Ki",
+                   "The integral gain per second squared of buffer level error",
+                   DoubleValue (0.001),
+                   MakeDoubleAccessor (&ElasticAlgorithm::m_ki),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Smoothing",
+                   "The weight of the newest segment in the harmonic average of the throughput",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&ElasticAlgorithm::m_smoothing),
+                   MakeDoubleChecker<double> (0.001, 1))
+    .AddAttribute ("MinDenominator",
+                   "The lower bound of 1 - Kp * q - Ki * qI, i.e. the requested bitrate is at most the throughput divided by it",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&ElasticAlgorithm::m_minDenominator),
+                   MakeDoubleChecker<double> (0.01))
+    .AddAttribute ("MaxDenominator",
+                   "The upper bound of 1 - Kp * q - Ki * qI, i.e. the requested bitrate is at least the throughput divided by it",
+                   DoubleValue (4),
+                   MakeDoubleAccessor (&ElasticAlgorithm::m_maxDenominator),
+                   MakeDoubleChecker<double> (1))
+  ;
+  return tid;
+}
+
+ElasticAlgorithm::ElasticAlgorithm (  const videoData &videoData,
+                                      const playbackData & playbackData,
+                                      const bufferData & bufferData,
+                                      const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1),
+  m_integral (0),
+  m_harmonicThroughput (0),
+  m_lastDecision (0),
+  m_lastRepIndex (0)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+}
+
+void
+ElasticAlgorithm::DoConstruct (void)
+{
+  // start where the controller neither speeds up nor slows down at the set point
+  if (m_ki > 0)
+    {
+      m_integral = -m_kp * (m_targetBuffer / 1000000.0) / m_ki;
+    }
+}
+
+algorithmReply
+ElasticAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  algorithmReply answer;
+  answer.decisionTime = timeNow;
+
+  if (segmentCounter == 0 || m_throughput.bytesReceived.empty ())
+    {
+      m_lastDecision = timeNow;
+      m_lastRepIndex = 0;
+      answer.nextRepIndex = 0;
+      answer.decisionCase = 0;
+      return answer;
+    }
+
+  int64_t duration = m_throughput.transmissionEnd.back () - m_throughput.transmissionRequested.back ();
+  if (duration > 0)
+    {
+      double throughput = m_throughput.bytesReceived.back () * 8 / (double) duration;
+      m_harmonicThroughput = m_harmonicThroughput == 0 ? throughput
+        : 1 / (m_smoothing / throughput + (1 - m_smoothing) / m_harmonicThroughput);
+    }
+  if (m_harmonicThroughput == 0)
+    {
+      m_lastDecision = timeNow;
+      answer.nextRepIndex = m_lastRepIndex;
+      answer.decisionCase = 0;
+      return answer;
+    }
+
+  int64_t bufferNow = GetBufferNow (timeNow);
+  double buffer = bufferNow / 1000000.0;
+  double error = buffer - m_targetBuffer / 1000000.0;
+  double elapsed = (timeNow - m_lastDecision) / 1000000.0;
+  m_lastDecision = timeNow;
+
+  double integral = m_integral + error * elapsed;
+  double denominator = 1 - m_kp * buffer - m_ki * integral;
+  answer.decisionCase = 1;
+  if (denominator < m_minDenominator || denominator > m_maxDenominator)
+    {
+      // saturated: keep the integral where it was
+      denominator = std::min (std::max (denominator, m_minDenominator), m_maxDenominator);
+      answer.decisionCase = 2;
+    }
+  else
+    {
+      m_integral = integral;
+    }
+  double rate = m_harmonicThroughput / denominator;
+
+  int64_t nextRepIndex = 0;
+  while (nextRepIndex < m_highestRepIndex && m_videoData.averageBitrate.at (nextRepIndex + 1) / 1000000.0 <= rate)
+    {
+      nextRepIndex++;
+    }
+
+  // OFF periods only when the buffer is more than one segment above the set point
+  int64_t excess = bufferNow - (int64_t) m_targetBuffer - m_videoData.segmentDuration;
+  if (excess > 0)
+    {
+      answer.nextDownloadDelay = excess;
+      answer.delayDecisionCase = 1;
+    }
+
+  m_lastRepIndex = nextRepIndex;
+  answer.nextRepIndex = nextRepIndex;
+  answer.bandwidthEstimate = m_harmonicThroughput;
+  return answer;
+}
+} // namespace ns3
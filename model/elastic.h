@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ELASTIC_ALGORITHM_H
+#define ELASTIC_ALGORITHM_H
+
+#include "tcp-stream-adaptation-algorithm.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Buffer feedback control in the style of ELASTIC (De Cicco et al., Packet Video 2013)
+ *
+ * A proportional-integral controller drives the buffer level q towards TargetBuffer. The requested
+ * bitrate is
+ * \code
+ * r = d / (1 - Kp * q - Ki * qI)
+ * \endcode
+ * with d the harmonic exponential average of the segment throughputs, q in seconds and qI the
+ * integral of q - TargetBuffer over the time between decisions. The integral starts where the
+ * controller is neutral at the set point and is not updated while the denominator is saturated
+ * (anti-windup). The highest representation not above r is requested.
+ *
+ * The controller keeps the connection busy: the next request is only delayed while the buffer is
+ * more than one segment above the set point, which keeps OFF periods, and the throughput bias they
+ * cause on shared bottlenecks, to a minimum. The state is O(1) per decision.
+ */
+class ElasticAlgorithm : public AdaptationAlgorithm
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  ElasticAlgorithm (  const videoData &videoData,
+                      const playbackData & playbackData,
+                      const bufferData & bufferData,
+                      const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+protected:
+  virtual void DoConstruct (void);
+
+private:
+  const int64_t m_highestRepIndex;
+  uint64_t m_targetBuffer; //!< the buffer level set point in microseconds
+  double m_kp; //!< proportional gain per second of buffer
+  double m_ki; //!< integral gain per second squared of buffer error
+  double m_smoothing; //!< weight of the newest segment in the harmonic average of the throughput
+  double m_minDenominator; //!< lower bound of the controller's denominator
+  double m_maxDenominator; //!< upper bound of the controller's denominator
+  double m_integral; //!< the integral of the buffer error in seconds squared, qI
+  double m_harmonicThroughput; //!< the harmonic average of the throughput in Mbit/s, 0 before the first segment
+  int64_t m_lastDecision; //!< the point in time in microseconds of the last decision
+  int64_t m_lastRepIndex;
+};
+} // namespace ns3
+#endif /* ELASTIC_ALGORITHM_H */
@@ -95,6 +95,11 @@ FestiveAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
       harmonicMeanDenominator += 1 / (thrptEstimationTmp.at (i));
     }
   double thrptEstimation = thrptEstimationTmp.size () / harmonicMeanDenominator;
+  double predicted = PredictThroughput ();
+  if (predicted > 0)
+    {
+      thrptEstimation = predicted;
+    }
   thrptEstimation = thrptEstimation * m_thrptThrsh;
   answer.bandwidthEstimate = thrptEstimation/(double)1000000;
 
@@ -0,0 +1,335 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "low-latency.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LowLatencyAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED (L2aAlgorithm);
+NS_OBJECT_ENSURE_REGISTERED (LolpAlgorithm);
+
+/**
+ * \return the throughput of the last segment in Mbit/s, 0 if there is none
+ */
+static double
+LastSegmentThroughput (const throughputData &throughput)
+{
+  if (throughput.bytesReceived.empty ())
+    {
+      return 0;
+    }
+  int64_t duration = throughput.transmissionEnd.back () - throughput.transmissionRequested.back ();
+  return duration > 0 ? throughput.bytesReceived.back () * 8 / (double) duration : 0;
+}
+
+/* L2A-LL: horizon 4, as in dash.js */
+static const double l2aHorizon = 4;
+static const double l2aReact = 2;
+
+L2aAlgorithm::L2aAlgorithm (  const videoData &videoData,
+                              const playbackData & playbackData,
+                              const bufferData & bufferData,
+                              const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1),
+  m_vl (std::pow (l2aHorizon, 0.99)),
+  m_alpha (std::max (l2aHorizon, m_vl * std::sqrt (l2aHorizon))),
+  m_queue (m_vl),
+  m_steady (false),
+  m_lastRepIndex (0)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      m_bitrates.push_back (videoData.averageBitrate.at (r) / 1000000.0);
+    }
+  m_weights.assign (m_highestRepIndex + 1, 0);
+  m_previousWeights.assign (m_highestRepIndex + 1, 0);
+  m_sorted.assign (m_highestRepIndex + 1, 0);
+}
+
+void
+L2aAlgorithm::ProjectWeights ()
+{
+  std::copy (m_weights.begin (), m_weights.end (), m_sorted.begin ());
+  std::sort (m_sorted.begin (), m_sorted.end (), std::greater<double> ());
+  double sum = 0;
+  double theta = 0;
+  for (size_t i = 0; i < m_sorted.size (); i++)
+    {
+      sum += m_sorted.at (i);
+      double candidate = (sum - 1) / (i + 1);
+      if (m_sorted.at (i) - candidate > 0)
+        {
+          theta = candidate;
+        }
+    }
+  for (size_t i = 0; i < m_weights.size (); i++)
+    {
+      m_weights.at (i) = std::max (m_weights.at (i) - theta, 0.0);
+    }
+}
+
+algorithmReply
+L2aAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  algorithmReply answer;
+  answer.decisionTime = timeNow;
+
+  double throughput = LastSegmentThroughput (m_throughput);
+  if (segmentCounter == 0 || throughput <= 0)
+    {
+      m_lastRepIndex = 0;
+      answer.nextRepIndex = 0;
+      answer.decisionCase = 0;
+      return answer;
+    }
+  answer.bandwidthEstimate = throughput;
+
+  if (!m_steady)
+    {
+      // start with all the probability on the highest representation below the throughput
+      int64_t nextRepIndex = 0;
+      while (nextRepIndex < m_highestRepIndex && m_bitrates.at (nextRepIndex + 1) < throughput)
+        {
+          nextRepIndex++;
+        }
+      std::fill (m_weights.begin (), m_weights.end (), 0.0);
+      m_weights.at (nextRepIndex) = 1;
+      m_previousWeights = m_weights;
+      m_queue = m_vl;
+      m_steady = true;
+      m_lastRepIndex = nextRepIndex;
+      answer.nextRepIndex = nextRepIndex;
+      answer.decisionCase = 1;
+      return answer;
+    }
+
+  double segmentDuration = m_videoData.segmentDuration / 1000000.0;
+  double rate = m_playbackData.playbackRate.empty () ? 1.0 : m_playbackData.playbackRate.back ();
+  // the bitrates are sorted, so once one of them drains the buffer all higher ones do
+  double sign = 1;
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      if (rate * m_bitrates.at (r) > throughput)
+        {
+          sign = -1;
+        }
+      m_weights.at (r) = m_previousWeights.at (r)
+        + sign * (segmentDuration / (2 * m_alpha)) * ((m_queue + m_vl) * (rate * m_bitrates.at (r) / throughput));
+    }
+  ProjectWeights ();
+
+  double expected = 0;
+  double change = 0;
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      expected += m_bitrates.at (r) * m_weights.at (r);
+      change += m_bitrates.at (r) * (m_weights.at (r) - m_previousWeights.at (r));
+    }
+  m_previousWeights = m_weights;
+  m_queue = std::max (0.0, m_queue - segmentDuration + segmentDuration * rate * (expected + change) / throughput);
+
+  int64_t nextRepIndex = 0;
+  for (int64_t r = 1; r <= m_highestRepIndex; r++)
+    {
+      if (std::fabs (m_bitrates.at (r) - expected) < std::fabs (m_bitrates.at (nextRepIndex) - expected))
+        {
+          nextRepIndex = r;
+        }
+    }
+  answer.decisionCase = 2;
+  // step up cautiously, one representation at a time
+  if (nextRepIndex > m_lastRepIndex)
+    {
+      nextRepIndex = m_bitrates.at (m_lastRepIndex + 1) <= throughput ? m_lastRepIndex + 1 : m_lastRepIndex;
+      answer.decisionCase = 3;
+    }
+  // the throughput was overestimated, weigh the next step more
+  if (m_bitrates.at (nextRepIndex) >= throughput)
+    {
+      m_queue = l2aReact * std::max (m_vl, m_queue);
+    }
+
+  m_lastRepIndex = nextRepIndex;
+  answer.nextRepIndex = nextRepIndex;
+  return answer;
+}
+
+TypeId
+LolpAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LolpAlgorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("LiveDelay",
+                   "The live latency in microseconds the playback rate is controlled to",
+                   UintegerValue (3000000),
+                   MakeUintegerAccessor (&LolpAlgorithm::m_liveDelay),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("PlaybackRateChange",
+                   "The largest deviation of the playback rate from 1",
+                   DoubleValue (0.3),
+                   MakeDoubleAccessor (&LolpAlgorithm::m_rateChange),
+                   MakeDoubleChecker<double> (0, 0.9))
+    .AddAttribute ("MinBuffer",
+                   "The buffer level in microseconds below which the playback is slowed down and no representation is chosen whose download would empty the buffer further",
+                   UintegerValue (500000),
+                   MakeUintegerAccessor (&LolpAlgorithm::m_minBuffer),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("LearningRate",
+                   "The share of the distance to the measured state a neuron moves per segment",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&LolpAlgorithm::m_learningRate),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("Neighbourhood",
+                   "The width of the neighbourhood of the updated neuron, as a share of the highest bitrate",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&LolpAlgorithm::m_neighbourhood),
+                   MakeDoubleChecker<double> (0.001))
+  ;
+  return tid;
+}
+
+LolpAlgorithm::LolpAlgorithm (  const videoData &videoData,
+                                const playbackData & playbackData,
+                                const bufferData & bufferData,
+                                const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1),
+  m_lastRepIndex (0),
+  m_previousRepIndex (0)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      m_bitrates.push_back (videoData.averageBitrate.at (r) / 1000000.0);
+      neuronState neuron = {m_bitrates.back () / (videoData.averageBitrate.back () / 1000000.0), 0, 0, 0};
+      m_neurons.push_back (neuron);
+    }
+}
+
+void
+LolpAlgorithm::UpdateNeurons (const neuronState &measured)
+{
+  double highest = m_bitrates.back ();
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      double distance = (m_bitrates.at (r) - m_bitrates.at (m_lastRepIndex)) / highest;
+      double neighbourhood = std::exp (-distance * distance / (2 * m_neighbourhood * m_neighbourhood));
+      double step = m_learningRate * neighbourhood;
+      neuronState &neuron = m_neurons.at (r);
+      neuron.throughput += step * (measured.throughput - neuron.throughput);
+      neuron.latency += step * (measured.latency - neuron.latency);
+      neuron.rebuffer += step * (measured.rebuffer - neuron.rebuffer);
+      neuron.switches += step * (measured.switches - neuron.switches);
+    }
+}
+
+double
+LolpAlgorithm::GetPlaybackRate (double latency, double bufferLevel) const
+{
+  double deviation = latency - m_liveDelay / 1000000.0;
+  // a sigmoid between 1 - m_rateChange and 1 + m_rateChange, 1 at the target latency
+  double rate = (1 - m_rateChange) + 2 * m_rateChange / (1 + std::exp (-5 * deviation));
+  double minBuffer = m_minBuffer / 1000000.0;
+  if (bufferLevel < minBuffer)
+    {
+      // catching up now would only cause stalls
+      double slowDown = (1 - m_rateChange) + 2 * m_rateChange / (1 + std::exp (-5 * (bufferLevel - minBuffer)));
+      rate = std::min (rate, slowDown);
+    }
+  return rate;
+}
+
+algorithmReply
+LolpAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  algorithmReply answer;
+  answer.decisionTime = timeNow;
+
+  double throughput = LastSegmentThroughput (m_throughput);
+  if (segmentCounter == 0 || throughput <= 0)
+    {
+      m_lastRepIndex = 0;
+      m_previousRepIndex = 0;
+      answer.nextRepIndex = 0;
+      answer.decisionCase = 0;
+      return answer;
+    }
+  answer.bandwidthEstimate = throughput;
+
+  double segmentDuration = m_videoData.segmentDuration / 1000000.0;
+  double bufferLevel = GetBufferNow (timeNow) / 1000000.0;
+  double latency = 0;
+  if (!m_playbackData.liveLatency.empty ())
+    {
+      // the latency changes by 1 - rate per second of playback since the start of the current segment
+      double played = (timeNow - m_playbackData.playbackStart.back ()) / 1000000.0;
+      latency = m_playbackData.liveLatency.back () / 1000000.0 + played * (1 - m_playbackData.playbackRate.back ());
+    }
+
+  double highest = m_bitrates.back ();
+  neuronState measured;
+  measured.throughput = throughput / highest;
+  measured.latency = latency;
+  measured.rebuffer = std::max (0.0, m_bitrates.at (m_lastRepIndex) * segmentDuration / throughput - bufferLevel);
+  measured.switches = std::fabs (m_bitrates.at (m_lastRepIndex) - m_bitrates.at (m_previousRepIndex)) / highest;
+  UpdateNeurons (measured);
+
+  // the winner is the neuron closest to the ideal state at the measured throughput
+  int64_t nextRepIndex = 0;
+  double best = 0;
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      const neuronState &neuron = m_neurons.at (r);
+      double throughputWeight = m_bitrates.at (r) > throughput ? 100 : 1;
+      double nextBuffer = bufferLevel + segmentDuration - m_bitrates.at (r) * segmentDuration / throughput;
+      double rebufferWeight = nextBuffer < m_minBuffer / 1000000.0 ? 100 : 1;
+      double switches = std::fabs (m_bitrates.at (r) - m_bitrates.at (m_lastRepIndex)) / highest;
+      double distance = throughputWeight * std::pow (neuron.throughput - measured.throughput, 2)
+        + std::pow (neuron.latency, 2)
+        + rebufferWeight * std::pow (neuron.rebuffer, 2)
+        + std::pow (neuron.switches + switches, 2);
+      if (r == 0 || distance < best)
+        {
+          best = distance;
+          nextRepIndex = r;
+        }
+    }
+
+  m_previousRepIndex = m_lastRepIndex;
+  m_lastRepIndex = nextRepIndex;
+  answer.nextRepIndex = nextRepIndex;
+  answer.decisionCase = 1;
+  if (!m_playbackData.liveLatency.empty ())
+    {
+      answer.playbackRate = GetPlaybackRate (latency, bufferLevel);
+    }
+  return answer;
+}
+} // namespace ns3
@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOW_LATENCY_ALGORITHM_H
+#define LOW_LATENCY_ALGORITHM_H
+
+#include "tcp-stream-adaptation-algorithm.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief L2A-LL (Learn2Adapt-LowLatency), following the dash.js L2ARule
+ *
+ * The algorithm keeps a probability for every representation and updates it by online gradient
+ * descent after every segment: the probability of representations whose bitrate, at the current
+ * playback rate, exceeds the last segment's throughput falls, the others rise, and the result is
+ * projected back onto the probability simplex. A virtual queue (Lagrange multiplier) grows while
+ * the expected bitrate would drain the buffer and weighs the next step. The representation closest
+ * to the expected bitrate is requested, but the algorithm never steps up by more than one
+ * representation, and only if its bitrate is below the throughput. The first decision after the
+ * first segment uses the throughput alone.
+ */
+class L2aAlgorithm : public AdaptationAlgorithm
+{
+public:
+  L2aAlgorithm (  const videoData &videoData,
+                  const playbackData & playbackData,
+                  const bufferData & bufferData,
+                  const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+private:
+  /**
+   * \brief Project m_weights onto the probability simplex (Euclidean projection, Duchi et al.).
+   */
+  void ProjectWeights ();
+
+  const int64_t m_highestRepIndex;
+  std::vector<double> m_bitrates; //!< average bitrate of every representation in Mbit/s
+  std::vector<double> m_weights; //!< probability of every representation
+  std::vector<double> m_previousWeights; //!< m_weights before the last update
+  std::vector<double> m_sorted; //!< scratch space of ProjectWeights ()
+  const double m_vl; //!< the virtual queue's floor
+  const double m_alpha; //!< the inverse step size of the gradient descent
+  double m_queue; //!< the virtual queue
+  bool m_steady; //!< false until the first decision based on the throughput was made
+  int64_t m_lastRepIndex;
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief LoL+, following the dash.js LoLpRule
+ *
+ * Every representation is a neuron of a self-organizing map whose state is (throughput, live
+ * latency, rebuffering, bitrate switch), the throughput and the switch normalized by the highest
+ * bitrate, the others in seconds. After every segment, the neuron of the representation that was
+ * played last and its neighbours are moved towards the measured state; then the neuron closest to
+ * (throughput, 0, 0, 0) is requested. Neurons whose bitrate exceeds the throughput, or whose download
+ * would bring the buffer below MinBuffer, are kept away by a large distance weight.
+ *
+ * LoL+ also controls the playback rate: it follows a sigmoid of the deviation of the live latency
+ * from LiveDelay between 1 - PlaybackRateChange and 1 + PlaybackRateChange, and slows down whenever
+ * the buffer is below MinBuffer. The client bounds the rate by its MinPlaybackRate and
+ * MaxPlaybackRate attributes.
+ */
+class LolpAlgorithm : public AdaptationAlgorithm
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  LolpAlgorithm (  const videoData &videoData,
+                   const playbackData & playbackData,
+                   const bufferData & bufferData,
+                   const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+private:
+  /**
+   * \brief The state of a neuron, or a measured state.
+   */
+  struct neuronState
+  {
+    double throughput; //!< throughput / highest bitrate
+    double latency; //!< live latency in seconds
+    double rebuffer; //!< rebuffering in seconds
+    double switches; //!< bitrate switch / highest bitrate
+  };
+  /**
+   * \brief Move the neuron of m_lastRepIndex and its neighbours towards the measured state.
+   */
+  void UpdateNeurons (const neuronState &measured);
+  /**
+   * \return the playback rate for the live latency and buffer level, both in seconds
+   */
+  double GetPlaybackRate (double latency, double bufferLevel) const;
+
+  const int64_t m_highestRepIndex;
+  uint64_t m_liveDelay; //!< the live latency in microseconds the playback rate is controlled to
+  double m_rateChange; //!< the largest deviation of the playback rate from 1
+  uint64_t m_minBuffer; //!< the buffer level in microseconds below which the playback is slowed down
+  double m_learningRate; //!< the share of the distance a neuron moves per segment
+  double m_neighbourhood; //!< the width of the neighbourhood, in normalized bitrate
+  std::vector<double> m_bitrates; //!< average bitrate of every representation in Mbit/s
+  std::vector<neuronState> m_neurons; //!< one neuron per representation
+  int64_t m_lastRepIndex;
+  int64_t m_previousRepIndex; //!< the representation requested before m_lastRepIndex
+};
+} // namespace ns3
+#endif /* LOW_LATENCY_ALGORITHM_H */
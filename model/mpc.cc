@@ -11,6 +11,16 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("MPCAlgo");
 NS_OBJECT_ENSURE_REGISTERED (MPCAlgo);
 
+TypeId
+MPCAlgo::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MPCAlgo")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+  ;
+  return tid;
+}
+
 MPCAlgo::MPCAlgo (const videoData &videoData, const playbackData & playbackData, const bufferData & bufferData, const throughputData & throughput) : AdaptationAlgorithm (videoData, playbackData, bufferData, throughput), m_highestRepIndex (videoData.averageBitrate.size () - 1)
 {
   NS_LOG_INFO (this);
@@ -82,6 +92,10 @@ algorithmReply MPCAlgo::GetNextRep ( const int64_t segmentCounter, int64_t clien
 	}
 	double future_bandwidth = harmonic_bandwidth/(1+max_error);
 	past_bandwidth_ests.push_front(harmonic_bandwidth);
+	double predicted_bandwidth = PredictThroughput();
+	if (predicted_bandwidth > 0) {
+		future_bandwidth = predicted_bandwidth;
+	}
 
 	double max_reward = -100000000;
 	double start_buffer = (m_bufferData.bufferLevelNew.back ()/ (double)1000000 - (timeNow - m_bufferData.timeNow.back())/ (double)1000000);
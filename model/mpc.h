@@ -5,9 +5,22 @@
 
 namespace ns3 {
 
+/**
+ * \ingroup tcpStream
+ * \brief Implementation of the MPC adaptation algorithm, based on the Pensieve implementation
+ *
+ * The bandwidth is predicted by the harmonic mean of the last 5 segments divided by 1 + the largest
+ * of the last 5 relative prediction errors, or by the predictor given by the Predictor attribute.
+ */
 class MPCAlgo : public AdaptationAlgorithm
 {
 public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
   MPCAlgo (  const videoData &videoData,
                       const playbackData & playbackData,
                       const bufferData & bufferData,
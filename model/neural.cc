@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "neural.h"
+#include "ns3/abort.h"
+#include "ns3/string.h"
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NeuralAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED (NeuralAlgorithm);
+
+static const uint32_t vectorWidth = sizeof (neuralVector) / sizeof (float);
+
+TypeId
+NeuralAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::NeuralAlgorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("WeightFile",
+                   "The file with the weights of the policy network, see NeuralAlgorithm",
+                   StringValue (""),
+                   MakeStringAccessor (&NeuralAlgorithm::m_weightFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+NeuralAlgorithm::NeuralAlgorithm (  const videoData &videoData,
+                                    const playbackData & playbackData,
+                                    const bufferData & bufferData,
+                                    const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1),
+  m_model (0),
+  m_lastRepIndex (0)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+}
+
+void
+NeuralAlgorithm::DoConstruct (void)
+{
+  m_model = LoadModel (m_weightFile);
+  NS_ABORT_MSG_IF (m_model == 0, "Reading the weight file " << m_weightFile << " failed.");
+  uint32_t inputs = 2 * m_model->history + m_highestRepIndex + 4;
+  NS_ABORT_MSG_IF (m_model->layers.front ().inputs != inputs,
+                   "The network in " << m_weightFile << " needs " << m_model->layers.front ().inputs << " inputs, the state has " << inputs);
+  NS_ABORT_MSG_IF (m_model->layers.back ().outputs != (uint32_t) m_highestRepIndex + 1,
+                   "The network in " << m_weightFile << " has " << m_model->layers.back ().outputs << " outputs, the video " << m_highestRepIndex + 1 << " representations");
+  neuralVector zero = {0, 0, 0, 0};
+  m_input.assign (m_model->width, zero);
+  m_output.assign (m_model->width, zero);
+}
+
+const NeuralAlgorithm::model *
+NeuralAlgorithm::LoadModel (std::string weightFile)
+{
+  static std::map<std::string, model> models;
+  std::map<std::string, model>::iterator it = models.find (weightFile);
+  if (it != models.end ())
+    {
+      return &it->second;
+    }
+
+  std::ifstream file (weightFile.c_str ());
+  if (!file)
+    {
+      return 0;
+    }
+  // all tokens outside of comment lines
+  std::stringstream tokens;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      if (line.empty () || line.at (0) != '#')
+        {
+          tokens << line << " ";
+        }
+    }
+
+  model network;
+  network.history = 0;
+  network.width = 0;
+  std::string keyword;
+  while (tokens >> keyword)
+    {
+      if (keyword == "history")
+        {
+          tokens >> network.history;
+          continue;
+        }
+      if (keyword != "layer")
+        {
+          NS_LOG_ERROR ("Unexpected " << keyword << " in " << weightFile);
+          return 0;
+        }
+      layer dense;
+      std::string activation;
+      if (!(tokens >> dense.inputs >> dense.outputs >> activation) || dense.inputs == 0 || dense.outputs == 0
+          || (!network.layers.empty () && network.layers.back ().outputs != dense.inputs))
+        {
+          NS_LOG_ERROR ("Invalid layer " << network.layers.size () << " in " << weightFile);
+          return 0;
+        }
+      dense.relu = activation == "relu";
+      dense.blocks = (dense.inputs + vectorWidth - 1) / vectorWidth;
+      neuralVector zero = {0, 0, 0, 0};
+      dense.weights.assign (dense.outputs * dense.blocks, zero);
+      for (uint32_t o = 0; o < dense.outputs; o++)
+        {
+          for (uint32_t i = 0; i < dense.inputs; i++)
+            {
+              float weight;
+              if (!(tokens >> weight))
+                {
+                  NS_LOG_ERROR ("Missing weights of layer " << network.layers.size () << " in " << weightFile);
+                  return 0;
+                }
+              dense.weights.at (o * dense.blocks + i / vectorWidth)[i % vectorWidth] = weight;
+            }
+        }
+      dense.bias.assign (dense.outputs, 0);
+      for (uint32_t o = 0; o < dense.outputs; o++)
+        {
+          if (!(tokens >> dense.bias.at (o)))
+            {
+              NS_LOG_ERROR ("Missing biases of layer " << network.layers.size () << " in " << weightFile);
+              return 0;
+            }
+        }
+      network.width = std::max (network.width, std::max (dense.blocks, (dense.outputs + vectorWidth - 1) / vectorWidth));
+      network.layers.push_back (dense);
+    }
+  if (network.layers.empty ())
+    {
+      return 0;
+    }
+  NS_LOG_INFO ("Loaded " << network.layers.size () << " layers from " << weightFile);
+  return &(models[weightFile] = network);
+}
+
+void
+NeuralAlgorithm::BuildState (int64_t segmentCounter, int64_t timeNow)
+{
+  float *state = reinterpret_cast<float *> (&m_input.front ());
+  uint32_t history = m_model->history;
+  uint32_t k = 0;
+  state[k++] = m_videoData.averageBitrate.at (m_lastRepIndex) / m_videoData.averageBitrate.back ();
+  state[k++] = GetBufferNow (timeNow) / 10000000.0;
+  int64_t downloaded = m_throughput.bytesReceived.size ();
+  for (uint32_t h = 0; h < history; h++)
+    {
+      int64_t index = downloaded - history + h;
+      float throughput = 0;
+      float downloadTime = 0;
+      if (index >= 0)
+        {
+          int64_t duration = m_throughput.transmissionEnd.at (index) - m_throughput.transmissionRequested.at (index);
+          downloadTime = duration / 10000000.0;
+          throughput = duration > 0 ? m_throughput.bytesReceived.at (index) / (double) duration : 0;
+        }
+      // bytes per microsecond are MByte/s
+      state[k + h] = throughput;
+      state[k + history + h] = downloadTime;
+    }
+  k += 2 * history;
+  int64_t segmentIndex = m_playbackData.contentIndex.at (segmentCounter);
+  for (int64_t r = 0; r <= m_highestRepIndex; r++)
+    {
+      state[k++] = m_videoData.segmentSize.at (r).at (segmentIndex) / 1000000.0;
+    }
+  int64_t segments = m_videoData.segmentSize.at (0).size ();
+  state[k++] = (segments - segmentIndex) / (float) segments;
+  // the padding of the last vector stays 0
+  for (; k % vectorWidth != 0; k++)
+    {
+      state[k] = 0;
+    }
+}
+
+const float *
+NeuralAlgorithm::Infer ()
+{
+  neuralVector *in = &m_input.front ();
+  neuralVector *out = &m_output.front ();
+  for (size_t l = 0; l < m_model->layers.size (); l++)
+    {
+      const layer &dense = m_model->layers.at (l);
+      const neuralVector *weights = &dense.weights.front ();
+      float *result = reinterpret_cast<float *> (out);
+      for (uint32_t o = 0; o < dense.outputs; o++)
+        {
+          const neuralVector *row = weights + o * dense.blocks;
+          neuralVector sum = {0, 0, 0, 0};
+          for (uint32_t b = 0; b < dense.blocks; b++)
+            {
+              sum += row[b] * in[b];
+            }
+          float value = sum[0] + sum[1] + sum[2] + sum[3] + dense.bias.at (o);
+          result[o] = dense.relu && value < 0 ? 0 : value;
+        }
+      // zero the padding, it is the next layer's input
+      for (uint32_t o = dense.outputs; o % vectorWidth != 0; o++)
+        {
+          result[o] = 0;
+        }
+      std::swap (in, out);
+    }
+  return reinterpret_cast<const float *> (in);
+}
+
+algorithmReply
+NeuralAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  algorithmReply answer;
+  answer.decisionTime = timeNow;
+  answer.nextDownloadDelay = 0;
+  answer.delayDecisionCase = 0;
+  answer.bandwidthEstimate = 0;
+
+  if (segmentCounter == 0)
+    {
+      m_lastRepIndex = 0;
+      answer.nextRepIndex = 0;
+      answer.decisionCase = 0;
+      return answer;
+    }
+
+  BuildState (segmentCounter, timeNow);
+  const float *scores = Infer ();
+  int64_t nextRepIndex = 0;
+  for (int64_t r = 1; r <= m_highestRepIndex; r++)
+    {
+      if (scores[r] > scores[nextRepIndex])
+        {
+          nextRepIndex = r;
+        }
+    }
+  m_lastRepIndex = nextRepIndex;
+  answer.nextRepIndex = nextRepIndex;
+  answer.decisionCase = 1;
+  if (!m_throughput.bytesReceived.empty ())
+    {
+      int64_t duration = m_throughput.transmissionEnd.back () - m_throughput.transmissionRequested.back ();
+      answer.bandwidthEstimate = duration > 0 ? m_throughput.bytesReceived.back () * 8 / (double) duration : 0;
+    }
+  return answer;
+}
+} // namespace ns3
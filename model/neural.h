@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NEURAL_ALGORITHM_H
+#define NEURAL_ALGORITHM_H
+
+#include "tcp-stream-adaptation-algorithm.h"
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \brief Four floats processed at once, mapped to SSE or NEON registers by GCC and Clang.
+ */
+typedef float neuralVector __attribute__ ((vector_size (16)));
+
+/**
+ * \ingroup tcpStream
+ * \brief Learned adaptation policy (Pensieve-style) evaluated by a multilayer perceptron
+ *
+ * The state is built as in Pensieve, oldest history entry first:
+ * - bitrate of the last representation / highest bitrate
+ * - buffer level in seconds / 10
+ * - throughput of the last History segments in MByte/s, 0 where there is no segment yet
+ * - download time of the last History segments in seconds / 10
+ * - size of the next segment in every representation in MByte
+ * - share of the segments left to download
+ *
+ * so the network has 2 * History + number of representations + 3 inputs and one output per
+ * representation; the representation with the highest output is requested. The weights are read
+ * from WeightFile once per process and shared by all clients. Inference uses a vectorised dense
+ * kernel and buffers allocated when the algorithm is created, so a decision does not allocate.
+ *
+ * The weight file is plain text; lines starting with # are comments:
+ * \code
+ * history 8
+ * layer <inputs> <outputs> relu|linear
+ * <outputs lines of inputs weights>
+ * <one line of outputs biases>
+ * layer ...
+ * \endcode
+ */
+class NeuralAlgorithm : public AdaptationAlgorithm
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  NeuralAlgorithm (  const videoData &videoData,
+                     const playbackData & playbackData,
+                     const bufferData & bufferData,
+                     const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+  /**
+   * \brief A dense layer, the weight rows are padded with zeros to whole vectors.
+   */
+  struct layer
+  {
+    uint32_t inputs; //!< number of inputs
+    uint32_t outputs; //!< number of outputs
+    uint32_t blocks; //!< number of vectors per weight row
+    bool relu; //!< true for a ReLU activation, false for a linear one
+    std::vector<neuralVector> weights; //!< outputs rows of blocks vectors
+    std::vector<float> bias; //!< one bias per output
+  };
+  /**
+   * \brief A multilayer perceptron read from a weight file.
+   */
+  struct model
+  {
+    uint32_t history; //!< number of past segments in the state
+    uint32_t width; //!< the largest number of vectors of any layer's input or output
+    std::vector<layer> layers; //!< the layers from input to output
+  };
+
+protected:
+  virtual void DoConstruct (void);
+
+private:
+  /**
+   * \return the model read from the weight file, cached per file
+   */
+  static const model * LoadModel (std::string weightFile);
+  /**
+   * \brief Fill m_input with the state for the next segment.
+   */
+  void BuildState (int64_t segmentCounter, int64_t timeNow);
+  /**
+   * \brief Run the network on m_input.
+   * \return the output layer's values
+   */
+  const float * Infer ();
+
+  const int64_t m_highestRepIndex;
+  std::string m_weightFile; //!< the file the weights are read from
+  const model *m_model; //!< the network, shared by all clients using the same weight file
+  std::vector<neuralVector> m_input; //!< the activations of the even layers' inputs
+  std::vector<neuralVector> m_output; //!< the activations of the odd layers' inputs
+  int64_t m_lastRepIndex;
+};
+} // namespace ns3
+#endif /* NEURAL_ALGORITHM_H */
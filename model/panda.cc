@@ -17,6 +17,8 @@
  */
 
 #include "panda.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
 
 
 namespace ns3 {
@@ -25,17 +27,51 @@ NS_LOG_COMPONENT_DEFINE ("PandaAlgorithm");
 
 NS_OBJECT_ENSURE_REGISTERED (PandaAlgorithm);
 
+TypeId
+PandaAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PandaAlgorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("Kappa",
+                   "The probing convergence rate",
+                   DoubleValue (0.14),
+                   MakeDoubleAccessor (&PandaAlgorithm::m_kappa),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Omega",
+                   "The probing additive increase bitrate in Mbit/s",
+                   DoubleValue (0.3),
+                   MakeDoubleAccessor (&PandaAlgorithm::m_omega),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Alpha",
+                   "The smoothing convergence rate",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&PandaAlgorithm::m_alpha),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Beta",
+                   "The client buffer convergence rate",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&PandaAlgorithm::m_beta),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("Epsilon",
+                   "The quantization margin of the upshift",
+                   DoubleValue (0.15),
+                   MakeDoubleAccessor (&PandaAlgorithm::m_epsilon),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("BMin",
+                   "The minimum client buffer level in seconds",
+                   IntegerValue (26),
+                   MakeIntegerAccessor (&PandaAlgorithm::m_bMin),
+                   MakeIntegerChecker<int64_t> (0))
+  ;
+  return tid;
+}
+
 PandaAlgorithm::PandaAlgorithm (  const videoData &videoData,
                                   const playbackData & playbackData,
                                   const bufferData & bufferData,
                                   const throughputData & throughput) :
   AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
-  m_kappa (0.14),
-  m_omega (0.3),
-  m_alpha (0.2),
-  m_beta (0.2),
-  m_epsilon (0.15),
-  m_bMin (26),
   m_highestRepIndex (videoData.averageBitrate.size () - 1)
 {
   NS_LOG_INFO (this);
@@ -68,6 +104,11 @@ PandaAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
 
 	double throughputMeasured = ((double)((8.0 * m_throughput.bytesReceived.back()))
                                / (double)((m_throughput.transmissionEnd.back () - m_throughput.transmissionRequested.back ()) / 1e6)) / 1e6;
+  double predicted = PredictThroughput ();
+  if (predicted > 0)
+    {
+      throughputMeasured = predicted / 1e6;
+    }
 	
   //if (segmentCounter == 1)
 	if(firstDone == false)
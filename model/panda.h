@@ -30,6 +30,12 @@ namespace ns3 {
 class PandaAlgorithm : public AdaptationAlgorithm
 {
 public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
   PandaAlgorithm (  const videoData &videoData,
                     const playbackData & playbackData,
                     const bufferData & bufferData,
@@ -39,12 +45,12 @@ public:
 
 private:
   int FindLargest (const double smoothBandwidthShare, const int64_t segmentCounter, const double delta);
-  const double m_kappa;
-  const double m_omega;
-  const double m_alpha;
-  const double m_beta;
-  const double m_epsilon;
-  const int64_t m_bMin;
+  double m_kappa;
+  double m_omega;
+  double m_alpha;
+  double m_beta;
+  double m_epsilon;
+  int64_t m_bMin;
   const int64_t m_highestRepIndex;
   double m_lastBuffer;
   double m_lastTargetInterrequestTime;
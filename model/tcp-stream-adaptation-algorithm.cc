@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #include "tcp-stream-adaptation-algorithm.h"
+#include "ns3/string.h"
 
 namespace ns3 {
 
@@ -23,6 +24,27 @@ NS_LOG_COMPONENT_DEFINE ("AdaptationAlgorithm");
 
 NS_OBJECT_ENSURE_REGISTERED (AdaptationAlgorithm);
 
+TypeId
+AdaptationAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AdaptationAlgorithm")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("Predictor",
+                   "The bandwidth predictor, e.g. ns3::KalmanBandwidthPredictor or ns3::HoltBandwidthPredictor[Alpha=0.3], empty for the algorithm's own throughput estimate",
+                   StringValue (""),
+                   MakeStringAccessor (&AdaptationAlgorithm::m_predictorName),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TypeId
+AdaptationAlgorithm::GetInstanceTypeId (void) const
+{
+  return m_tid;
+}
+
 AdaptationAlgorithm::AdaptationAlgorithm (  const videoData & videoData,
                                             const playbackData & playbackData,
                                             const bufferData & bufferData,
@@ -30,8 +52,88 @@ AdaptationAlgorithm::AdaptationAlgorithm (  const videoData & videoData,
   m_videoData (videoData),
   m_bufferData (bufferData),
   m_throughput (throughput),
-  m_playbackData (playbackData)
+  m_playbackData (playbackData),
+  m_transport (0),
+  m_predictor (0),
+  m_predictedSegments (0),
+  m_tid (GetTypeId ())
+{
+}
+
+void
+AdaptationAlgorithm::Construct (TypeId tid)
+{
+  m_tid = tid;
+  ConstructSelf (AttributeConstructionList ());
+  m_predictor = BandwidthPredictor::Create (m_predictorName);
+  DoConstruct ();
+}
+
+double
+AdaptationAlgorithm::GetPredictionError () const
+{
+  return m_predictor == 0 ? -1 : m_predictor->GetMeanError ();
+}
+
+void
+AdaptationAlgorithm::DoConstruct (void)
+{
+}
+
+double
+AdaptationAlgorithm::GetBinThroughput (uint32_t bins) const
+{
+  uint64_t capacity = m_throughput.binStart.size ();
+  uint64_t count = std::min ((uint64_t) bins, std::min (capacity, m_throughput.binsWritten));
+  int64_t bytes = 0;
+  int64_t length = 0;
+  for (uint64_t i = 1; i <= count; i++)
+    {
+      uint64_t slot = (m_throughput.binsWritten - i) % capacity;
+      bytes += m_throughput.binBytes.at (slot);
+      length += m_throughput.binLength.at (slot);
+    }
+  if (length <= 0)
+    {
+      return 0;
+    }
+  return bytes * 8 / (length / (double) 1000000);
+}
+
+int64_t
+AdaptationAlgorithm::GetBufferNow (int64_t timeNow) const
+{
+  if (m_playbackData.playbackStart.empty () || m_bufferData.timeNow.empty ())
+    {
+      return m_bufferData.bufferLevelNew.back ();
+    }
+  double rate = m_playbackData.playbackRate.empty () ? 1.0 : m_playbackData.playbackRate.back ();
+  int64_t elapsed = (int64_t)((timeNow - m_bufferData.timeNow.back ()) * rate);
+  return std::max (m_bufferData.bufferLevelNew.back () - elapsed, (int64_t) 0);
+}
+
+double
+AdaptationAlgorithm::PredictThroughput ()
+{
+  if (m_predictor == 0)
+    {
+      return 0;
+    }
+  for (; m_predictedSegments < m_throughput.bytesReceived.size (); m_predictedSegments++)
+    {
+      int64_t duration = m_throughput.transmissionEnd.at (m_predictedSegments) - m_throughput.transmissionRequested.at (m_predictedSegments);
+      if (duration > 0)
+        {
+          m_predictor->Update (m_throughput.bytesReceived.at (m_predictedSegments) * 8 / (duration / (double) 1000000));
+        }
+    }
+  return m_predictor->Predict ();
+}
+
+void
+AdaptationAlgorithm::SetTransportData (const transportData *transport)
 {
+  m_transport = transport;
 }
 
 } // namespace ns3
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "ns3/simulator.h"
 #include <stdint.h>
 #include "tcp-stream-interface.h"
+#include "bandwidth-predictor.h"
 #include <stdexcept>
 #include <assert.h>
 #include <math.h>
@@ -37,15 +38,35 @@ namespace ns3 {
  * \ingroup tcpStream
  * \brief A base class for adaptation algorithms
  *
+ * As the algorithms hold references to the data of their client, they are created with new instead of
+ * CreateObject. The client then calls Construct () to apply the attributes of the algorithm.
  */
 class AdaptationAlgorithm : public Object
 {
 public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
   AdaptationAlgorithm ( const videoData &videoData,
                         const playbackData & playbackData,
                         const bufferData & bufferData,
                         const throughputData & throughput  );
 
+  /**
+   * \brief Apply the attribute defaults of the given type, create the Predictor and finish the setup with DoConstruct ().
+   *
+   * \param tid the TypeId of the algorithm
+   */
+  void Construct (TypeId tid);
+  /**
+   * \return the mean relative error of the predictions of m_predictor so far, -1 without predictor
+   */
+  double GetPredictionError () const;
+
   /**
    * \ingroup tcpStream
    * \brief Compute the next representation index
@@ -56,11 +77,50 @@ public:
    */
   virtual algorithmReply GetNextRep ( const int64_t segmentCounter, int64_t clientId) = 0;
 
+  /**
+   * \brief Give the algorithm access to the TCP state of the client's connection.
+   *
+   * \param transport the transportData of the client, updated from the server's socket (see TcpStreamTransportRegistry)
+   */
+  void SetTransportData (const transportData *transport);
+
 protected:
+  /**
+   * \brief Setup that depends on attribute values, called by Construct () after the attributes were applied.
+   */
+  virtual void DoConstruct (void);
+  /**
+   * \brief Throughput of the most recent throughput bins (see throughputData).
+   *
+   * \param bins the number of bins, fewer are used if the ring buffer holds fewer
+   * \return the throughput in bits per second over these bins, 0 if there are none
+   */
+  double GetBinThroughput (uint32_t bins) const;
+  /**
+   * \brief Buffer level at timeNow, drained at the current playback rate since the last buffer update.
+   *
+   * \param timeNow the current time in microseconds
+   * \return the buffer level in microseconds, not below 0
+   */
+  int64_t GetBufferNow (int64_t timeNow) const;
+  /**
+   * \brief Feed the throughput of the segments downloaded since the last call to m_predictor.
+   *
+   * \return the predicted throughput of the next segment in bits per second, 0 without predictor or measurements
+   */
+  double PredictThroughput ();
+
   const videoData & m_videoData;
   const bufferData & m_bufferData;
   const throughputData & m_throughput;
   const playbackData & m_playbackData;
+  const transportData * m_transport; //!< TCP state of the connection, 0 if the client does not provide it
+  std::string m_predictorName; //!< the bandwidth predictor and its attributes, empty for the algorithm's own estimate
+  Ptr<BandwidthPredictor> m_predictor; //!< the bandwidth predictor, 0 if the algorithm uses its own estimate
+  size_t m_predictedSegments; //!< number of segments m_predictor was fed
+
+private:
+  TypeId m_tid; //!< the TypeId of the algorithm, set by Construct ()
 };
 } // namespace ns3
 
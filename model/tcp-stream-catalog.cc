@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-catalog.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamCatalog");
+
+TcpStreamCatalog &
+TcpStreamCatalog::Get ()
+{
+  static TcpStreamCatalog catalog;
+  return catalog;
+}
+
+TcpStreamCatalog::TcpStreamCatalog ()
+{
+}
+
+const videoData *
+TcpStreamCatalog::GetVideo (std::string segmentSizeFile, int64_t segmentDuration, bool layered)
+{
+  std::pair<std::string, int64_t> key (segmentSizeFile, segmentDuration);
+  if (layered)
+    {
+      std::map<std::pair<std::string, int64_t>, videoData>::iterator it = m_layeredVideos.find (key);
+      if (it != m_layeredVideos.end ())
+        {
+          return &it->second;
+        }
+      const videoData *layers = GetVideo (segmentSizeFile, segmentDuration);
+      if (layers == 0)
+        {
+          return 0;
+        }
+      videoData video = *layers;
+      for (size_t i = 1; i < video.segmentSize.size (); i++)
+        {
+          video.averageBitrate.at (i) += video.averageBitrate.at (i - 1);
+          for (size_t j = 0; j < video.segmentSize.at (i).size () && j < video.segmentSize.at (i - 1).size (); j++)
+            {
+              video.segmentSize.at (i).at (j) += video.segmentSize.at (i - 1).at (j);
+            }
+        }
+      return &(m_layeredVideos[key] = video);
+    }
+  std::map<std::pair<std::string, int64_t>, videoData>::iterator it = m_videos.find (key);
+  if (it != m_videos.end ())
+    {
+      return &it->second;
+    }
+
+  std::ifstream myfile (segmentSizeFile.c_str ());
+  if (!myfile)
+    {
+      return 0;
+    }
+  videoData video;
+  video.segmentDuration = segmentDuration;
+  std::string temp;
+  while (std::getline (myfile, temp))
+    {
+      if (temp.empty ())
+        {
+          break;
+        }
+      std::istringstream buffer (temp);
+      std::vector<int64_t> line ((std::istream_iterator<int64_t> (buffer)),
+                                 std::istream_iterator<int64_t>());
+      video.averageBitrate.push_back (line.at (0));
+      line.erase (line.begin ());
+      video.segmentSize.push_back (line);
+    }
+  if (video.segmentSize.empty ())
+    {
+      return 0;
+    }
+  NS_LOG_INFO ("Loaded " << segmentSizeFile << " with " << video.segmentSize.size () << " representations");
+  // std::map never moves its elements, the pointer stays valid for the lifetime of the process
+  return &(m_videos[key] = video);
+}
+
+const videoData *
+TcpStreamCatalog::GetTiledVideo (std::string tileGridFile, int64_t segmentDuration)
+{
+  std::pair<std::string, int64_t> key (tileGridFile, segmentDuration);
+  std::map<std::pair<std::string, int64_t>, videoData>::iterator it = m_tiledVideos.find (key);
+  if (it != m_tiledVideos.end ())
+    {
+      return &it->second;
+    }
+
+  std::ifstream file (tileGridFile.c_str ());
+  if (!file)
+    {
+      return 0;
+    }
+  videoData video;
+  video.segmentDuration = segmentDuration;
+  if (!(file >> video.tileRows >> video.tileColumns) || video.tileRows <= 0 || video.tileColumns <= 0)
+    {
+      return 0;
+    }
+  for (int64_t tile = 0; tile < video.tileRows * video.tileColumns; tile++)
+    {
+      std::string tileFile;
+      if (!(file >> tileFile))
+        {
+          return 0;
+        }
+      // the tile files are cached like any other video, tiles may share a file
+      const videoData *tileVideo = GetVideo (tileFile, segmentDuration);
+      if (tileVideo == 0)
+        {
+          return 0;
+        }
+      if (tile == 0)
+        {
+          video.segmentSize = tileVideo->segmentSize;
+          video.averageBitrate = tileVideo->averageBitrate;
+        }
+      else
+        {
+          if (tileVideo->segmentSize.size () != video.segmentSize.size ())
+            {
+              return 0;
+            }
+          for (size_t i = 0; i < video.segmentSize.size (); i++)
+            {
+              if (tileVideo->segmentSize.at (i).size () != video.segmentSize.at (i).size ())
+                {
+                  return 0;
+                }
+              video.averageBitrate.at (i) += tileVideo->averageBitrate.at (i);
+              for (size_t j = 0; j < video.segmentSize.at (i).size (); j++)
+                {
+                  video.segmentSize.at (i).at (j) += tileVideo->segmentSize.at (i).at (j);
+                }
+            }
+        }
+      video.tileSize.push_back (tileVideo->segmentSize);
+    }
+  NS_LOG_INFO ("Loaded " << tileGridFile << " with " << video.tileRows << "x" << video.tileColumns << " tiles");
+  return &(m_tiledVideos[key] = video);
+}
+
+const std::vector<std::string> *
+TcpStreamCatalog::GetTitles (std::string catalogFile)
+{
+  std::map<std::string, std::vector<std::string> >::iterator it = m_catalogs.find (catalogFile);
+  if (it != m_catalogs.end ())
+    {
+      return &it->second;
+    }
+
+  std::ifstream file (catalogFile.c_str ());
+  if (!file)
+    {
+      return 0;
+    }
+  std::vector<std::string> titles;
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream buffer (line);
+      std::string title;
+      if (buffer >> title)
+        {
+          titles.push_back (title);
+        }
+    }
+  if (titles.empty ())
+    {
+      return 0;
+    }
+  return &(m_catalogs[catalogFile] = titles);
+}
+
+uint32_t
+TcpStreamCatalog::DrawTitle (uint32_t titles, double exponent, double u)
+{
+  std::pair<uint32_t, double> key (titles, exponent);
+  std::vector<double> &cdf = m_zipf[key];
+  if (cdf.empty ())
+    {
+      double sum = 0;
+      for (uint32_t i = 1; i <= titles; i++)
+        {
+          sum += 1.0 / std::pow (i, exponent);
+          cdf.push_back (sum);
+        }
+      for (uint32_t i = 0; i < titles; i++)
+        {
+          cdf.at (i) /= sum;
+        }
+    }
+  uint32_t title = std::upper_bound (cdf.begin (), cdf.end (), u) - cdf.begin ();
+  return std::min (title, titles - 1);
+}
+
+} // namespace ns3
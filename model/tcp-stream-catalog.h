@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_CATALOG_H
+#define TCP_STREAM_CATALOG_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "tcp-stream-interface.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Per-process store of the videos of all clients.
+ *
+ * Every segment size file is read once per segment duration and shared by all clients playing it, so
+ * the memory for the segment sizes grows with the number of titles, not with the number of clients.
+ * A catalog file lists the segment size files of the titles, one per line, the line number (starting
+ * at 0) is the video id. Titles are drawn from a Zipf distribution over the video ids, whose cumulative
+ * distribution is computed once per catalog size and exponent.
+ */
+class TcpStreamCatalog
+{
+public:
+  static TcpStreamCatalog & Get ();
+
+  /**
+   * \param segmentSizeFile the segment size file, one line per representation: the average bitrate followed by the segment sizes in bytes
+   * \param segmentDuration the segment duration in microseconds
+   * \param layered true if the lines of the file are the layers of a scalable video, base layer first:
+   * representation i is then made of the layers 0 to i, its sizes and bitrate are the sums over these layers
+   * \return the shared video data, 0 if the file can't be read
+   */
+  const videoData * GetVideo (std::string segmentSizeFile, int64_t segmentDuration, bool layered = false);
+  /**
+   * \param tileGridFile the tile grid file: the number of tile rows and columns on the first line, then the
+   * segment size file of every tile, row by row (paths relative to the working directory)
+   * \param segmentDuration the segment duration in microseconds
+   * \return the shared video data with the sizes of every tile, 0 if a file can't be read or the tiles
+   * don't have the same number of representations and segments
+   */
+  const videoData * GetTiledVideo (std::string tileGridFile, int64_t segmentDuration);
+  /**
+   * \param catalogFile the catalog file, one segment size file per line
+   * \return the segment size files of all titles, 0 if the catalog can't be read
+   */
+  const std::vector<std::string> * GetTitles (std::string catalogFile);
+  /**
+   * \brief Draw a video id from a Zipf distribution.
+   *
+   * \param titles the number of titles
+   * \param exponent the Zipf exponent, 0 for uniform popularity
+   * \param u a uniform random number in [0, 1)
+   * \return the video id, title 0 is the most popular
+   */
+  uint32_t DrawTitle (uint32_t titles, double exponent, double u);
+
+private:
+  TcpStreamCatalog ();
+
+  std::map<std::pair<std::string, int64_t>, videoData> m_videos; //!< the videos by segment size file and segment duration
+  std::map<std::pair<std::string, int64_t>, videoData> m_layeredVideos; //!< the scalable videos by segment size file and segment duration, cumulated over the layers
+  std::map<std::pair<std::string, int64_t>, videoData> m_tiledVideos; //!< the tiled videos by tile grid file and segment duration
+  std::map<std::string, std::vector<std::string> > m_catalogs; //!< the titles by catalog file
+  std::map<std::pair<uint32_t, double>, std::vector<double> > m_zipf; //!< the cumulative Zipf distributions by number of titles and exponent
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_CATALOG_H */
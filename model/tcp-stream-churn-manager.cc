@@ -0,0 +1,404 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-churn-manager.h"
+#include "tcp-stream-client.h"
+#include "tcp-stream-interface.h"
+#include "tcp-stream-qoe.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/enum.h"
+#include "ns3/pointer.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/node.h"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamChurnManager");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpStreamChurnManager);
+
+TypeId
+TcpStreamChurnManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpStreamChurnManager")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<TcpStreamChurnManager> ()
+    .AddAttribute ("ArrivalProcess",
+                   "The client arrival process: Poisson, FlashCrowd or Trace",
+                   EnumValue (POISSON),
+                   MakeEnumAccessor (&TcpStreamChurnManager::m_arrivalProcess),
+                   MakeEnumChecker (POISSON, "Poisson",
+                                    FLASH_CROWD, "FlashCrowd",
+                                    TRACE, "Trace"))
+    .AddAttribute ("ArrivalRate",
+                   "The mean number of arriving clients per second of the Poisson and FlashCrowd processes",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&TcpStreamChurnManager::m_arrivalRate),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("FlashCrowdRate",
+                   "The additional number of arriving clients per second during the flash crowd",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&TcpStreamChurnManager::m_flashCrowdRate),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("FlashCrowdStart",
+                   "The start of the flash crowd, relative to the start of the arrival process",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&TcpStreamChurnManager::m_flashCrowdStart),
+                   MakeTimeChecker ())
+    .AddAttribute ("FlashCrowdDuration",
+                   "The duration of the flash crowd",
+                   TimeValue (Seconds (30)),
+                   MakeTimeAccessor (&TcpStreamChurnManager::m_flashCrowdDuration),
+                   MakeTimeChecker ())
+    .AddAttribute ("ArrivalTraceFile",
+                   "The path of the arrival trace, one arrival per line: time in seconds, optionally followed by the session length in seconds",
+                   StringValue (""),
+                   MakeStringAccessor (&TcpStreamChurnManager::m_arrivalTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("SessionLength",
+                   "The random variable for the session lengths in seconds, 0 to watch until the end of the video",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=0]"),
+                   MakePointerAccessor (&TcpStreamChurnManager::m_sessionLength),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("MaxClients",
+                   "The total number of arriving clients, 0 for no limit other than the 65536 client ids",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&TcpStreamChurnManager::m_maxClients),
+                   MakeUintegerChecker<uint32_t> (0, 65535))
+    .AddAttribute ("StopTime",
+                   "No clients arrive after this point in time, relative to the start of the arrival process, 0 for no limit",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TcpStreamChurnManager::m_stopTime),
+                   MakeTimeChecker ())
+    .AddAttribute ("StopSimulation",
+                   "Stop the simulation when no more clients arrive and the last session ended",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpStreamChurnManager::m_stopSimulation),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SimulationId",
+                   "The ID of the current simulation, for the output path",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamChurnManager::m_simulationId),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddTraceSource ("ClientArrived",
+                     "A client was installed on a node of the pool",
+                     MakeTraceSourceAccessor (&TcpStreamChurnManager::m_clientArrivedTrace),
+                     "ns3::TcpStreamChurnManager::ClientArrivedCallback")
+    .AddTraceSource ("LastSessionEnded",
+                     "The arrival process ended and the last session ended",
+                     MakeTraceSourceAccessor (&TcpStreamChurnManager::m_lastSessionEndedTrace),
+                     "ns3::TcpStreamChurnManager::LastSessionEndedCallback")
+  ;
+  return tid;
+}
+
+TcpStreamChurnManager::TcpStreamChurnManager ()
+  : m_traceIndex (0),
+    m_arrivals (0),
+    m_blocked (0),
+    m_nextClientId (0),
+    m_peakClients (0),
+    m_arrivalsDone (false)
+{
+  NS_LOG_FUNCTION (this);
+  m_interArrival = CreateObject<ExponentialRandomVariable> ();
+}
+
+TcpStreamChurnManager::~TcpStreamChurnManager ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TcpStreamChurnManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_arrivalEvent);
+  m_sessions.clear ();
+  m_nodes = NodeContainer ();
+  m_churnLog.close ();
+  Object::DoDispose ();
+}
+
+void
+TcpStreamChurnManager::Setup (const ObjectFactory &clientFactory, std::string algorithm, NodeContainer nodes)
+{
+  NS_LOG_FUNCTION (this << algorithm);
+  m_clientFactory = clientFactory;
+  m_algorithm = algorithm;
+  m_nodes = nodes;
+  m_freeNodes.clear ();
+  // hand out the nodes in container order
+  for (uint32_t i = nodes.GetN (); i > 0; i--)
+    {
+      m_freeNodes.push_back (i - 1);
+    }
+}
+
+void
+TcpStreamChurnManager::Start (Time start)
+{
+  NS_LOG_FUNCTION (this << start);
+  m_start = start;
+  if (m_arrivalProcess == TRACE && !ReadArrivalTrace ())
+    {
+      NS_LOG_ERROR ("Opening arrival trace " << m_arrivalTraceFile << " failed, no clients arrive");
+      return;
+    }
+  std::string churnLogName = dashLogDirectory + "/SimID_" + std::to_string (m_simulationId) + "/churnLog.txt";
+  m_churnLog.open (churnLogName.c_str ());
+  m_churnLog << "Time_Now Event Client_Id Node_Id Active_Clients\n";
+  // clients that did not arrive yet must not let the QoE summary be written early
+  TcpStreamQoeAggregator::Get ().Register (m_simulationId);
+  m_arrivalEvent = Simulator::Schedule (start, &TcpStreamChurnManager::ScheduleNextArrival, this);
+}
+
+bool
+TcpStreamChurnManager::ReadArrivalTrace ()
+{
+  NS_LOG_FUNCTION (this);
+  std::ifstream traceFile (m_arrivalTraceFile.c_str ());
+  if (!traceFile)
+    {
+      return false;
+    }
+  m_trace.clear ();
+  std::string line;
+  while (std::getline (traceFile, line))
+    {
+      std::istringstream buffer (line);
+      double arrivalTime;
+      if (!(buffer >> arrivalTime))
+        {
+          continue;
+        }
+      double sessionLength;
+      if (!(buffer >> sessionLength))
+        {
+          sessionLength = -1;
+        }
+      m_trace.push_back (std::make_pair (arrivalTime, sessionLength));
+    }
+  std::stable_sort (m_trace.begin (), m_trace.end ());
+  m_traceIndex = 0;
+  return true;
+}
+
+double
+TcpStreamChurnManager::GetArrivalRate (double t) const
+{
+  double rate = m_arrivalRate;
+  if (m_arrivalProcess == FLASH_CROWD && t >= m_flashCrowdStart.GetSeconds ()
+      && t < (m_flashCrowdStart + m_flashCrowdDuration).GetSeconds ())
+    {
+      rate += m_flashCrowdRate;
+    }
+  return rate;
+}
+
+double
+TcpStreamChurnManager::GetNextRateChange (double t) const
+{
+  if (m_arrivalProcess != FLASH_CROWD)
+    {
+      return -1;
+    }
+  if (t < m_flashCrowdStart.GetSeconds ())
+    {
+      return m_flashCrowdStart.GetSeconds ();
+    }
+  if (t < (m_flashCrowdStart + m_flashCrowdDuration).GetSeconds ())
+    {
+      return (m_flashCrowdStart + m_flashCrowdDuration).GetSeconds ();
+    }
+  return -1;
+}
+
+void
+TcpStreamChurnManager::ScheduleNextArrival ()
+{
+  NS_LOG_FUNCTION (this);
+  double now = (Simulator::Now () - m_start).GetSeconds ();
+  double next = -1;
+  double sessionLength = -1;
+  if (m_nextClientId > std::numeric_limits<uint16_t>::max ())
+    {
+      // client ids are 16 bit, a wrapped id would collide with a running session and its QoE entry
+      NS_LOG_WARN ("All client ids used, no more clients arrive");
+    }
+  else if (m_maxClients == 0 || m_arrivals < m_maxClients)
+    {
+      if (m_arrivalProcess == TRACE)
+        {
+          if (m_traceIndex < m_trace.size ())
+            {
+              next = std::max (m_trace.at (m_traceIndex).first, now);
+              sessionLength = m_trace.at (m_traceIndex).second;
+              m_traceIndex++;
+            }
+        }
+      else
+        {
+          // the rate is piecewise constant, so consume a unit exponential over the rate segments
+          // until it is used up, which yields the exact non-homogeneous Poisson arrival time
+          double work = m_interArrival->GetValue ();
+          double t = now;
+          while (next < 0)
+            {
+              double rate = GetArrivalRate (t);
+              double change = GetNextRateChange (t);
+              if (rate > 0 && (change < 0 || t + work / rate <= change))
+                {
+                  next = t + work / rate;
+                }
+              else if (change < 0)
+                {
+                  break;
+                }
+              else
+                {
+                  work -= rate * (change - t);
+                  t = change;
+                }
+            }
+        }
+    }
+  if (next < 0 || (!m_stopTime.IsZero () && next > m_stopTime.GetSeconds ()))
+    {
+      m_arrivalsDone = true;
+      TcpStreamQoeAggregator::Get ().Unregister ();
+      CheckDone ();
+      return;
+    }
+  m_arrivalEvent = Simulator::Schedule (Seconds (next - now), &TcpStreamChurnManager::Arrival, this, sessionLength);
+}
+
+void
+TcpStreamChurnManager::Arrival (double sessionLength)
+{
+  NS_LOG_FUNCTION (this << sessionLength);
+  m_arrivals++;
+  uint16_t clientId = m_nextClientId++;
+  if (m_freeNodes.empty ())
+    {
+      m_blocked++;
+      Log ("blocked", clientId, -1);
+      ScheduleNextArrival ();
+      return;
+    }
+  uint32_t nodeIndex = m_freeNodes.back ();
+  m_freeNodes.pop_back ();
+  Ptr<Node> node = m_nodes.Get (nodeIndex);
+
+  Ptr<TcpStreamClient> client = m_clientFactory.Create<TcpStreamClient> ();
+  client->SetAttribute ("ClientId", UintegerValue (clientId));
+  client->Initialise (m_algorithm, clientId);
+  client->TraceConnectWithoutContext ("SessionEnded", MakeCallback (&TcpStreamChurnManager::SessionEnded, this));
+  if (sessionLength < 0)
+    {
+      sessionLength = m_sessionLength->GetValue ();
+    }
+  if (sessionLength > 0)
+    {
+      // start and stop time are relative to the initialization of the application, which follows right away
+      client->SetStopTime (Seconds (sessionLength));
+    }
+  node->AddApplication (client);
+
+  session s;
+  s.client = client;
+  s.nodeIndex = nodeIndex;
+  m_sessions[clientId] = s;
+  m_peakClients = std::max (m_peakClients, (uint32_t) m_sessions.size ());
+  Log ("arrival", clientId, node->GetId ());
+  m_clientArrivedTrace (client);
+  ScheduleNextArrival ();
+}
+
+void
+TcpStreamChurnManager::SessionEnded (uint16_t clientId)
+{
+  NS_LOG_FUNCTION (this << clientId);
+  // the client is still inside StopApplication (), dispose it afterwards
+  Simulator::ScheduleNow (&TcpStreamChurnManager::Release, this, clientId);
+}
+
+void
+TcpStreamChurnManager::Release (uint16_t clientId)
+{
+  NS_LOG_FUNCTION (this << clientId);
+  std::map<uint16_t, session>::iterator it = m_sessions.find (clientId);
+  if (it == m_sessions.end ())
+    {
+      return;
+    }
+  Ptr<Node> node = m_nodes.Get (it->second.nodeIndex);
+  // ns-3 can't remove an application from its node, dispose it so that only the empty object remains
+  it->second.client->Dispose ();
+  m_freeNodes.push_back (it->second.nodeIndex);
+  m_sessions.erase (it);
+  Log ("departure", clientId, node->GetId ());
+  CheckDone ();
+}
+
+void
+TcpStreamChurnManager::CheckDone ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_arrivalsDone && m_sessions.empty ())
+    {
+      NS_LOG_INFO ("Arrival process ended: " << m_arrivals << " arrivals, " << m_blocked << " blocked, peak " << m_peakClients << " clients");
+      m_churnLog.close ();
+      m_lastSessionEndedTrace ();
+      if (m_stopSimulation)
+        {
+          Simulator::Stop ();
+        }
+    }
+}
+
+void
+TcpStreamChurnManager::Log (std::string event, uint16_t clientId, int64_t nodeId)
+{
+  m_churnLog << Simulator::Now ().GetMicroSeconds () / (double)1000000 << " "
+             << event << " "
+             << clientId << " "
+             << nodeId << " "
+             << m_sessions.size () << "\n";
+  m_churnLog.flush ();
+}
+
+uint32_t
+TcpStreamChurnManager::GetActiveClients () const
+{
+  return m_sessions.size ();
+}
+
+uint32_t
+TcpStreamChurnManager::GetPeakClients () const
+{
+  return m_peakClients;
+}
+
+} // namespace ns3
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_CHURN_MANAGER_H
+#define TCP_STREAM_CHURN_MANAGER_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+class TcpStreamClient;
+
+/**
+ * \ingroup tcpStream
+ * \brief Creates and tears down tcp stream clients according to an arrival process and a session length distribution.
+ *
+ * Clients arrive according to ArrivalProcess: a Poisson process with ArrivalRate, a Poisson process
+ * whose rate is raised by FlashCrowdRate between FlashCrowdStart and FlashCrowdStart + FlashCrowdDuration,
+ * or the arrival times (and optional session lengths) read from ArrivalTraceFile. Every arriving client
+ * is installed on a free node of the node pool and stays for a session length drawn from SessionLength
+ * (seconds, 0 to watch until the end of the video). When its session ended, the client is disposed,
+ * i.e. its socket, adaptation algorithm and per segment data are released, and its node returns to the
+ * pool. Arrivals finding no free node are blocked. Memory and sockets thus follow the number of concurrent
+ * viewers, not the total number of viewers. As every arrival takes a new 16 bit client id, the arrival
+ * process ends after 65536 arrivals at the latest. The simulation is stopped after the arrival process
+ * ended and the last session ended.
+ *
+ * Arrivals, departures and blocked arrivals are written to dashLogDirectory/SimID_<id>/churnLog.txt.
+ */
+class TcpStreamChurnManager : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TcpStreamChurnManager ();
+  virtual ~TcpStreamChurnManager ();
+
+  /**
+   * \brief The supported arrival processes.
+   */
+  enum ArrivalProcess
+  {
+    POISSON, FLASH_CROWD, TRACE
+  };
+
+  /**
+   * \brief Set what and where clients are installed, must be called before Start ().
+   *
+   * \param clientFactory factory for the clients, with all client attributes set
+   * \param algorithm the name of the adaptation algorithm of the clients
+   * \param nodes the node pool, every node hosts at most one client at a time
+   */
+  void Setup (const ObjectFactory &clientFactory, std::string algorithm, NodeContainer nodes);
+  /**
+   * \brief Start the arrival process.
+   *
+   * \param start the point in time of the first possible arrival, trace arrival times are relative to it
+   */
+  void Start (Time start);
+
+  /**
+   * \return the number of clients that are currently streaming
+   */
+  uint32_t GetActiveClients () const;
+  /**
+   * \return the highest number of concurrently streaming clients so far
+   */
+  uint32_t GetPeakClients () const;
+
+  /**
+   * TracedCallback signature for client arrivals.
+   *
+   * \param [in] client the installed client
+   */
+  typedef void (* ClientArrivedCallback)(Ptr<TcpStreamClient> client);
+  /**
+   * TracedCallback signature for the end of the last session.
+   */
+  typedef void (* LastSessionEndedCallback)(void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A running session.
+   */
+  struct session
+  {
+    Ptr<TcpStreamClient> client; //!< the client application
+    uint32_t nodeIndex; //!< index of the client's node in the node pool
+  };
+
+  /**
+   * \brief Read ArrivalTraceFile, one arrival per line: arrival time in seconds, optionally followed by the session length in seconds.
+   */
+  bool ReadArrivalTrace ();
+  /**
+   * \return the arrival rate in clients per second at time t in seconds
+   */
+  double GetArrivalRate (double t) const;
+  /**
+   * \return the first point in time after t in seconds at which the arrival rate changes, -1 if there is none
+   */
+  double GetNextRateChange (double t) const;
+  /**
+   * \brief Schedule the next arrival, or end the arrival process.
+   */
+  void ScheduleNextArrival ();
+  /**
+   * \brief Install a client on a free node.
+   *
+   * \param sessionLength the session length in seconds, 0 to watch until the end of the video, negative to draw it from SessionLength
+   */
+  void Arrival (double sessionLength);
+  /**
+   * \brief Trace sink of the SessionEnded trace source of the clients.
+   */
+  void SessionEnded (uint16_t clientId);
+  /**
+   * \brief Dispose the client and return its node to the pool.
+   */
+  void Release (uint16_t clientId);
+  /**
+   * \brief Stop the simulation once no more clients arrive and all sessions ended.
+   */
+  void CheckDone ();
+  void Log (std::string event, uint16_t clientId, int64_t nodeId);
+
+  ArrivalProcess m_arrivalProcess; //!< the arrival process
+  double m_arrivalRate; //!< clients per second of the Poisson processes
+  double m_flashCrowdRate; //!< additional clients per second during the flash crowd
+  Time m_flashCrowdStart; //!< start of the flash crowd, relative to the start of the arrival process
+  Time m_flashCrowdDuration; //!< duration of the flash crowd
+  std::string m_arrivalTraceFile; //!< path of the arrival trace
+  Ptr<RandomVariableStream> m_sessionLength; //!< session lengths in seconds, 0 to watch until the end of the video
+  uint32_t m_maxClients; //!< total number of arrivals, 0 for no limit
+  Time m_stopTime; //!< no arrivals after this point in time, relative to the start of the arrival process, 0 for no limit
+  uint16_t m_simulationId; //!< the Id of this simulation, for the output path
+  bool m_stopSimulation; //!< true if the simulation is stopped after the last session ended
+
+  ObjectFactory m_clientFactory; //!< creates the clients
+  std::string m_algorithm; //!< adaptation algorithm of the clients
+  NodeContainer m_nodes; //!< the node pool
+  std::vector<uint32_t> m_freeNodes; //!< indices of the nodes without a running session
+  std::map<uint16_t, session> m_sessions; //!< running sessions by client id
+  Ptr<ExponentialRandomVariable> m_interArrival; //!< unit exponential random variable for the Poisson processes
+  std::vector<std::pair<double, double> > m_trace; //!< arrival time and session length in seconds of the trace arrivals
+  size_t m_traceIndex; //!< the next trace arrival
+  Time m_start; //!< start of the arrival process
+  EventId m_arrivalEvent; //!< the next arrival
+  uint32_t m_arrivals; //!< number of arrivals so far, including blocked ones
+  uint32_t m_blocked; //!< number of arrivals that found no free node
+  uint32_t m_nextClientId; //!< id of the next client, arrivals end before it exceeds the 16 bit client ids
+  uint32_t m_peakClients; //!< highest number of concurrent sessions
+  bool m_arrivalsDone; //!< true once the arrival process ended
+  std::ofstream m_churnLog; //!< the churn log
+
+  TracedCallback<Ptr<TcpStreamClient> > m_clientArrivedTrace; //!< a client was installed
+  TracedCallback<> m_lastSessionEndedTrace; //!< the arrival process and the last session ended
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_CHURN_MANAGER_H */
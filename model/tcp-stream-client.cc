@@ -26,6 +26,11 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
+#include "ns3/abort.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/trace-source-accessor.h"
 #include "tcp-stream-client.h"
 #include <math.h>
@@ -35,6 +40,9 @@
 #include "ns3/global-value.h"
 #include <ns3/core-module.h>
 #include "tcp-stream-server.h"
+#include "tcp-stream-profiler.h"
+#include "tcp-stream-catalog.h"
+#include "tcp-stream-transport-registry.h"
 #include <unistd.h>
 #include <iterator>
 #include <numeric>
@@ -62,12 +70,33 @@ NS_OBJECT_ENSURE_REGISTERED (TcpStreamClient);
 void TcpStreamClient::Controller (controllerEvent event)
 {
   NS_LOG_FUNCTION (this);
+  DASH_PROFILE_SCOPE (profilerScope, CLIENT_CONTROLLER, m_profiling);
+
+  // catch up with the playback up to now, so that every event sees the same state as if every
+  // segment's playback had been its own event. A playback instant at the same time as a request
+  // event is handled after it, if its event would have been scheduled after the request event.
+  Time horizon = Simulator::Now ();
+  if ((event == irdFinished || event == delayedSend
+       || (event == playbackFinished && m_requestEvent.IsRunning () && m_requestEvent.GetTs () == (uint64_t) Simulator::Now ().GetTimeStep ()))
+      && Simulator::Now () - m_requestScheduled >= MicroSeconds (m_videoData->segmentDuration))
+    {
+      horizon = Simulator::Now () - TimeStep (1);
+    }
+  AdvancePlayback (horizon);
+
+  if (event == playbackFinished)
+    {
+      // the buffer may have drained, AdvancePlayback () handled the stall or the end of playback
+      SchedulePlaybackEvent ();
+      return;
+    }
   
   //Delay segment requests to simulate live dash streaming where segments become available periodically
   if(event == delayedSend)
   {
     RequestRepIndex ();
-    Send (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+    SendRequest ();
+    SchedulePlaybackEvent ();
     return;
   }
   
@@ -79,17 +108,33 @@ void TcpStreamClient::Controller (controllerEvent event)
     Time delay = MicroSeconds(getAvailabilityTime(m_segmentCounter)-Simulator::Now ().GetMicroSeconds ());
 	  if(delay <= 0) {
       RequestRepIndex ();
-		  Send (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+		  SendRequest ();
 	  } else {
-		  Simulator::Schedule (delay, &TcpStreamClient::Controller, this, ev);
+		  ScheduleRequest (delay, ev);
 	  }
       return;
     }
 
   if (state == downloading)
     {
-      PlaybackHandle ();
-      if (m_currentPlaybackIndex <= m_lastSegmentIndex)
+      if (GetPlayableSegments () * (int64_t) m_videoData->segmentDuration < GetPlaybackThreshold ()
+          && m_segmentCounter + 1 < m_lastSegmentIndex)
+        {
+          /*  e_ds  */
+          // not enough buffered to start or resume playback yet, keep on downloading
+          m_segmentCounter++;
+          controllerEvent ev = delayedSend;
+          Time delay = MicroSeconds(getAvailabilityTime(m_segmentCounter)-Simulator::Now ().GetMicroSeconds ());
+          if(delay <= 0) {
+            RequestRepIndex ();
+            SendRequest ();
+          } else {
+            ScheduleRequest (delay, ev);
+          }
+          return;
+        }
+      PlaybackHandle (Simulator::Now ().GetMicroSeconds ());
+      if (m_segmentCounter + 1 < m_lastSegmentIndex)
         {
           /*  e_d  */
           m_segmentCounter++;
@@ -98,19 +143,21 @@ void TcpStreamClient::Controller (controllerEvent event)
           Time delay = MicroSeconds(getAvailabilityTime(m_segmentCounter)-Simulator::Now ().GetMicroSeconds ());
           if(delay <= 0) {
             RequestRepIndex ();
-            Send (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+            SendRequest ();
           } else {
-            Simulator::Schedule (delay, &TcpStreamClient::Controller, this, ev);
+            ScheduleRequest (delay, ev);
           }
         }
       else
         {
           /*  e_df  */
+          // the last segment is already downloaded, start the playback without another request
           state = playing;
         }
-      controllerEvent ev = playbackFinished;
-      // std::cerr << "Client " << m_clientId << " " << Simulator::Now ().GetSeconds () << "\n";
-      Simulator::Schedule (MicroSeconds (m_videoData.segmentDuration), &TcpStreamClient::Controller, this, ev);
+      // the playback of the next segment is due when the playback of this one is finished
+      m_playbackRunning = true;
+      m_nextPlaybackTime = Simulator::Now () + GetPlaybackDuration ();
+      SchedulePlaybackEvent ();
       return;
     }
 
@@ -125,13 +172,13 @@ void TcpStreamClient::Controller (controllerEvent event)
               //RequestRepIndex ();
             }
 
-          if (m_bDelay > 0 && m_segmentCounter <= m_lastSegmentIndex)
+          if (m_bDelay > 0 && m_segmentCounter < m_lastSegmentIndex)
             {
               /*  e_dirs */
               state = playing;
               controllerEvent ev = irdFinished;
 
-              Simulator::Schedule (MicroSeconds (m_bDelay), &TcpStreamClient::Controller, this, ev);
+              ScheduleRequest (MicroSeconds (m_bDelay), ev);
             }
           else if (m_segmentCounter == m_lastSegmentIndex)
             {
@@ -145,34 +192,30 @@ void TcpStreamClient::Controller (controllerEvent event)
               Time delay = MicroSeconds(getAvailabilityTime(m_segmentCounter)-Simulator::Now ().GetMicroSeconds ());
               if(delay <= 0) {
                 RequestRepIndex ();
-                Send (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+                SendRequest ();
               } else {
-                Simulator::Schedule (delay, &TcpStreamClient::Controller, this, ev);
+                ScheduleRequest (delay, ev);
               }      
             }
-        }
-      else if (event == playbackFinished)
-        {
-          if (!PlaybackHandle ())
-            {
-              /*  e_pb  */
-              controllerEvent ev = playbackFinished;
-              // std::cerr << "FIRST CASE. Client " << m_clientId << " " << Simulator::Now ().GetSeconds () << "\n";
-              Simulator::Schedule (MicroSeconds (m_videoData.segmentDuration), &TcpStreamClient::Controller, this, ev);
-            }
-          else
+          if (state == playing)
             {
-              /*  e_pu  */
-              state = downloading;
+              // use the time until the next request for enhancement layers
+              StartUpgrade ();
             }
         }
+      SchedulePlaybackEvent ();
       return;
     }
 
 
   else if (state == playing)
     {
-      if (event == irdFinished)
+      if (event == irdFinished && m_upgradeInProgress)
+        {
+          // one download at a time, the request is sent when the enhancement layer arrived
+          m_requestAfterUpgrade = true;
+        }
+      else if (event == irdFinished)
         {
           /*  e_irc  */
           state = downloadingPlaying;
@@ -180,28 +223,167 @@ void TcpStreamClient::Controller (controllerEvent event)
           Time delay = MicroSeconds(getAvailabilityTime(m_segmentCounter)-Simulator::Now ().GetMicroSeconds ());
           if(delay <= 0) {
             RequestRepIndex ();
-            Send (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+            SendRequest ();
           } else {
-            Simulator::Schedule (delay, &TcpStreamClient::Controller, this, ev);
+            ScheduleRequest (delay, ev);
           }
         }
-      else if (event == playbackFinished && m_currentPlaybackIndex < m_lastSegmentIndex)
-        {
-          /*  e_pb  */
-          // std::cerr << "SECOND CASE. Client " << m_clientId << " " << Simulator::Now ().GetSeconds () << "\n";
-          PlaybackHandle ();
-          controllerEvent ev = playbackFinished;
-          Simulator::Schedule (MicroSeconds (m_videoData.segmentDuration), &TcpStreamClient::Controller, this, ev);
-        }
-      else if (event == playbackFinished && m_currentPlaybackIndex == m_lastSegmentIndex)
+      SchedulePlaybackEvent ();
+      return;
+    }
+}
+
+void TcpStreamClient::AdvancePlayback (Time timeNow)
+{
+  NS_LOG_FUNCTION (this << timeNow);
+  Time segmentDuration = MicroSeconds (m_videoData->segmentDuration);
+  while (m_playbackRunning && m_nextPlaybackTime <= timeNow)
+    {
+      if (state == playing && m_currentPlaybackIndex == m_lastSegmentIndex)
         {
-          PlaybackHandle ();
           /*  e_pf  */
+          PlaybackHandle (m_nextPlaybackTime.GetMicroSeconds ());
           state = terminal;
+          m_playbackRunning = false;
           StopApplication ();
         }
+      else if (GetPlayableSegments () > 0 && !IsWaitingForResume ())
+        {
+          /*  e_pb  */
+          PlaybackHandle (m_nextPlaybackTime.GetMicroSeconds ());
+          m_nextPlaybackTime += GetPlaybackDuration ();
+        }
+      else if (state == downloadingPlaying)
+        {
+          /*  e_pu  */
+          if (!m_bufferUnderrun)
+            {
+              PlaybackHandle (m_nextPlaybackTime.GetMicroSeconds ());
+            }
+          state = downloading;
+          m_playbackRunning = false;
+        }
+      else if (state == playing && m_currentPlaybackIndex < m_lastSegmentIndex)
+        {
+          if (!m_bufferUnderrun)
+            {
+              PlaybackHandle (m_nextPlaybackTime.GetMicroSeconds ());
+              m_nextPlaybackTime += segmentDuration;
+            }
+          else
+            {
+              // during a stall nothing happens at the playback instants until the next controller event
+              int64_t skipped = (timeNow - m_nextPlaybackTime).GetTimeStep () / segmentDuration.GetTimeStep () + 1;
+              m_nextPlaybackTime += MicroSeconds (skipped * m_videoData->segmentDuration);
+            }
+        }
+      else
+        {
+          m_playbackRunning = false;
+        }
+    }
+}
+
+void TcpStreamClient::SchedulePlaybackEvent ()
+{
+  NS_LOG_FUNCTION (this);
+  bool waiting = IsWaitingForResume ();
+  if (!m_playbackRunning || state == terminal || (state == playing && waiting))
+    {
       return;
     }
+  // the buffer runs dry (or the playback ends) after the playback of all buffered segments, during
+  // a stall the next playback instant hands over to the downloading state. With live catch-up, the
+  // buffered segments may be played at up to m_maxPlaybackRate.
+  Time drainTime = m_nextPlaybackTime;
+  if (!waiting)
+    {
+      double rate = m_targetLatency > 0 || m_requestedPlaybackRate > 0 ? std::max (m_maxPlaybackRate, 1.0) : 1.0;
+      drainTime += MicroSeconds (GetPlayableSegments () * (int64_t)(m_videoData->segmentDuration / rate));
+    }
+  if (m_playbackEvent.IsRunning ())
+    {
+      if (m_playbackEvent.GetTs () <= (uint64_t) drainTime.GetTimeStep ())
+        {
+          // firing early is harmless, it only reschedules
+          return;
+        }
+      Simulator::Cancel (m_playbackEvent);
+    }
+  controllerEvent ev = playbackFinished;
+  m_playbackEvent = Simulator::Schedule (drainTime - Simulator::Now (), &TcpStreamClient::Controller, this, ev);
+}
+
+void TcpStreamClient::UpdatePlaybackRate (int64_t liveLatency)
+{
+  NS_LOG_FUNCTION (this << liveLatency);
+  if (m_requestedPlaybackRate > 0)
+    {
+      // the adaptation algorithm controls the playback rate itself
+      m_playbackRate = std::min (std::max (m_requestedPlaybackRate, m_minPlaybackRate), m_maxPlaybackRate);
+      return;
+    }
+  if (m_targetLatency == 0)
+    {
+      return;
+    }
+  // speed up when behind the target latency, slow down when ahead of it
+  double rate = 1 + m_latencyGain * (liveLatency - (int64_t) m_targetLatency) / 1000000.0;
+  // but never speed up, and slow down, while the buffer behind this segment is below the safe level
+  int64_t bufferLevel = (GetPlayableSegments () - 1) * (int64_t) m_videoData->segmentDuration;
+  if (bufferLevel < (int64_t) m_safeBuffer)
+    {
+      rate = std::min (rate, 1 - m_bufferGain * (m_safeBuffer - bufferLevel) / 1000000.0);
+    }
+  m_playbackRate = std::min (std::max (rate, m_minPlaybackRate), m_maxPlaybackRate);
+}
+
+Time TcpStreamClient::GetPlaybackDuration () const
+{
+  return MicroSeconds ((int64_t)(m_videoData->segmentDuration / m_playbackRate.Get ()));
+}
+
+int64_t TcpStreamClient::GetPlaybackThreshold () const
+{
+  int64_t threshold;
+  if (!playbackStarted)
+    {
+      threshold = std::max ((int64_t) m_startupBuffer, (int64_t)(m_startupSegments * m_videoData->segmentDuration));
+    }
+  else
+    {
+      threshold = std::max ((int64_t) m_resumeBuffer, (int64_t)(m_resumeSegments * m_videoData->segmentDuration));
+    }
+  // never wait for more than the rest of the video
+  return std::min (threshold, (m_lastSegmentIndex - m_currentPlaybackIndex) * (int64_t) m_videoData->segmentDuration);
+}
+
+bool TcpStreamClient::IsWaitingForResume () const
+{
+  return m_bufferUnderrun && GetPlayableSegments () * (int64_t) m_videoData->segmentDuration < GetPlaybackThreshold ();
+}
+
+int64_t TcpStreamClient::GetPlayableSegments () const
+{
+  if (m_audioData == 0)
+    {
+      return m_segmentsInBuffer;
+    }
+  // the playback stalls if either track runs dry, the tracks are paired by content index
+  int64_t playable = 0;
+  while (playable < m_segmentsInBuffer
+         && m_audioBuffered.count (GetContentIndex (m_currentPlaybackIndex + playable)) > 0)
+    {
+      playable++;
+    }
+  return playable;
+}
+
+void TcpStreamClient::ScheduleRequest (Time delay, controllerEvent event)
+{
+  NS_LOG_FUNCTION (this);
+  m_requestScheduled = Simulator::Now ();
+  m_requestEvent = Simulator::Schedule (delay, &TcpStreamClient::Controller, this, event);
 }
 
 TypeId TcpStreamClient::GetTypeId (void)
@@ -230,6 +412,26 @@ TypeId TcpStreamClient::GetTypeId (void)
                    StringValue ("bitrates.txt"),
                    MakeStringAccessor (&TcpStreamClient::m_segmentSizeFilePath),
                    MakeStringChecker ())
+    .AddAttribute ("ShadowAlgorithms",
+                   "Comma separated list of adaptation algorithms that decide on the same data as the algorithm of the client, without affecting its requests, their decisions are written to the shadow log",
+                   StringValue (""),
+                   MakeStringAccessor (&TcpStreamClient::m_shadowAlgorithms),
+                   MakeStringChecker ())
+    .AddAttribute ("CatalogFile",
+                   "The file listing the segment size files of all titles, one per line, empty to play SegmentSizeFilePath",
+                   StringValue (""),
+                   MakeStringAccessor (&TcpStreamClient::m_catalogFile),
+                   MakeStringChecker ())
+    .AddAttribute ("VideoId",
+                   "The title of the catalog to play, -1 to draw it from a Zipf distribution",
+                   IntegerValue (-1),
+                   MakeIntegerAccessor (&TcpStreamClient::m_requestedVideoId),
+                   MakeIntegerChecker<int64_t> (-1))
+    .AddAttribute ("ZipfExponent",
+                   "The exponent of the Zipf popularity distribution of the titles, 0 for uniform popularity",
+                   DoubleValue (0.8),
+                   MakeDoubleAccessor (&TcpStreamClient::m_zipfExponent),
+                   MakeDoubleChecker<double> (0))
     .AddAttribute ("SimulationId",
                    "The ID of the current simulation, for logging purposes",
                    UintegerValue (0),
@@ -245,6 +447,208 @@ TypeId TcpStreamClient::GetTypeId (void)
                    UintegerValue (0),
                    MakeUintegerAccessor (&TcpStreamClient::m_clientId),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Profiling",
+                   "Count invocations, wall clock time and bytes of the client callbacks (see TcpStreamProfiler)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpStreamClient::m_profiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AlgorithmProfiling",
+                   "Count invocations and wall clock time of the adaptation algorithm (see TcpStreamProfiler)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpStreamClient::m_algorithmProfiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("StartupBuffer",
+                   "The buffer level in microseconds required to start playback",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_startupBuffer),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("StartupSegments",
+                   "The number of buffered segments required to start playback, the larger one of StartupBuffer and StartupSegments applies",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpStreamClient::m_startupSegments),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ResumeBuffer",
+                   "The buffer level in microseconds required to resume playback after a buffer underrun",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_resumeBuffer),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("ResumeSegments",
+                   "The number of buffered segments required to resume playback after a buffer underrun, the larger one of ResumeBuffer and ResumeSegments applies",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpStreamClient::m_resumeSegments),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxBuffer",
+                   "The maximum buffer level in microseconds, the next request is delayed until the segment fits into the buffer, 0 for no limit",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_maxBuffer),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("ThroughputBinDuration",
+                   "The duration in microseconds of the bins the throughput during a download is sampled in, 0 to disable",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_binDuration),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("ThroughputBins",
+                   "The number of most recent throughput bins kept for the adaptation algorithm",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&TcpStreamClient::m_binCapacity),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("TargetLatency",
+                   "The live latency in microseconds the playback rate is controlled to, 0 to always play at normal speed",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_targetLatency),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("MinPlaybackRate",
+                   "The lowest playback rate of the live latency control",
+                   DoubleValue (0.9),
+                   MakeDoubleAccessor (&TcpStreamClient::m_minPlaybackRate),
+                   MakeDoubleChecker<double> (0.1, 1.0))
+    .AddAttribute ("MaxPlaybackRate",
+                   "The highest playback rate of the live latency control",
+                   DoubleValue (1.1),
+                   MakeDoubleAccessor (&TcpStreamClient::m_maxPlaybackRate),
+                   MakeDoubleChecker<double> (1.0, 4.0))
+    .AddAttribute ("LatencyGain",
+                   "Change of the playback rate per second of live latency above (below) the target latency",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TcpStreamClient::m_latencyGain),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("SafeBuffer",
+                   "Below this buffer level in microseconds, the live latency control does not speed up the playback but slows it down",
+                   UintegerValue (1000000),
+                   MakeUintegerAccessor (&TcpStreamClient::m_safeBuffer),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("BufferGain",
+                   "Decrease of the playback rate per second of buffer level below SafeBuffer",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&TcpStreamClient::m_bufferGain),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("LiveStart",
+                   "The point in time in microseconds when the first segment of the live stream becomes available",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_liveStart),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("JoinAtLiveEdge",
+                   "Start streaming at the newest available segment (minus LiveEdgeDelay) instead of the first segment",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpStreamClient::m_joinAtLiveEdge),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LiveEdgeDelay",
+                   "How far in microseconds behind the live edge a client joins, rounded up to whole segments",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_liveEdgeDelay),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("DvrWindow",
+                   "How long in microseconds a segment stays available after it became available, expired segments are skipped, 0 for no limit",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_dvrWindow),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("ScalableVideo",
+                   "The lines of the segment size file are the layers of a scalable video, base layer first. Representation i is made of the layers 0 to i, and while waiting for the next request the client downloads enhancement layers of buffered segments",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpStreamClient::m_scalableVideo),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UpgradeMargin",
+                   "How long in microseconds an enhancement layer must be expected to arrive before the playback of its segment starts",
+                   UintegerValue (1000000),
+                   MakeUintegerAccessor (&TcpStreamClient::m_upgradeMargin),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("TiledVideo",
+                   "The segment size file (or every title of the catalog) is a tile grid file: the number of tile rows and columns, then the segment size file of every tile. Every tile is requested separately, at the representation the algorithm chose for it",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpStreamClient::m_tiledVideo),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TilePipelineDepth",
+                   "The number of tile requests that are outstanding on the connection at a time, 1 for no pipelining, 0 to request all tiles of a segment at once",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&TcpStreamClient::m_pipelineDepth),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("ViewportTraceFile",
+                   "The viewport trace of a tiled video, one sample per line: media time in seconds, yaw and pitch in degrees. Empty for a synthetic trace",
+                   StringValue (""),
+                   MakeStringAccessor (&TcpStreamClient::m_viewportTraceFile),
+                   MakeStringChecker ())
+    .AddAttribute ("ViewportSpeed",
+                   "The angular speed in degrees per second of the synthetic viewer while turning",
+                   DoubleValue (60),
+                   MakeDoubleAccessor (&TcpStreamClient::m_viewportSpeed),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ViewportDwell",
+                   "The mean time in microseconds the synthetic viewer looks at one direction",
+                   UintegerValue (3000000),
+                   MakeUintegerAccessor (&TcpStreamClient::m_viewportDwell),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("FieldOfViewYaw",
+                   "The horizontal field of view of the viewer in degrees",
+                   DoubleValue (100),
+                   MakeDoubleAccessor (&TcpStreamClient::m_fovYaw),
+                   MakeDoubleChecker<double> (0, 360))
+    .AddAttribute ("FieldOfViewPitch",
+                   "The vertical field of view of the viewer in degrees",
+                   DoubleValue (90),
+                   MakeDoubleAccessor (&TcpStreamClient::m_fovPitch),
+                   MakeDoubleChecker<double> (0, 180))
+    .AddAttribute ("AudioSegmentSizeFile",
+                   "The segment size file of a separate audio track, whose segments are as long as the video segments. Empty if audio and video are muxed",
+                   StringValue (""),
+                   MakeStringAccessor (&TcpStreamClient::m_audioSegmentSizeFile),
+                   MakeStringChecker ())
+    .AddAttribute ("AudioRepIndex",
+                   "The representation of the audio track, capped at its highest representation",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_audioRepIndex),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AudioLead",
+                   "How many segments the audio track is requested ahead of the video track",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamClient::m_audioLead),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("AudioPipelining",
+                   "Send the audio requests and the next video request back to back, instead of requesting the video segment when the audio segments arrived",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpStreamClient::m_audioPipelining),
+                   MakeBooleanChecker ())
+    .AddAttribute ("QoeSummary",
+                   "Add the QoE metrics of this client to the QoE summary of the simulation (see TcpStreamQoeAggregator)",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpStreamClient::m_qoeSummary),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EnableFileLogging",
+                   "Write the download, playback, adaptation, buffer, throughput and buffer underrun log files of this client",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpStreamClient::m_fileLogging),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("SegmentDownloaded",
+                     "A segment was completely downloaded",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_segmentDownloadedTrace),
+                     "ns3::TcpStreamClient::SegmentDownloadedCallback")
+    .AddTraceSource ("RepresentationSwitched",
+                     "The representation of the requested segment differs from the one of the previous segment",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_representationSwitchedTrace),
+                     "ns3::TcpStreamClient::RepresentationSwitchedCallback")
+    .AddTraceSource ("BufferLevel",
+                     "The buffer level after a downloaded segment was added to the buffer",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_bufferLevelTrace),
+                     "ns3::TcpStreamClient::BufferLevelCallback")
+    .AddTraceSource ("StallStarted",
+                     "The playback stalled because the buffer ran empty",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_stallStartedTrace),
+                     "ns3::TcpStreamClient::StallStartedCallback")
+    .AddTraceSource ("StallEnded",
+                     "The playback resumed after a buffer underrun",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_stallEndedTrace),
+                     "ns3::TcpStreamClient::StallEndedCallback")
+    .AddTraceSource ("PlaybackRate",
+                     "The playback rate chosen by the live latency control",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_playbackRate),
+                     "ns3::TracedValueCallback::Double")
+    .AddTraceSource ("PlaybackStarted",
+                     "The playback of a segment started, reported by the next controller event at the latest with the actual playback time (see AdvancePlayback)",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_playbackStartedTrace),
+                     "ns3::TcpStreamClient::PlaybackStartedCallback")
+    .AddTraceSource ("SessionEnded",
+                     "The streaming session ended, because the video was played or the application was stopped",
+                     MakeTraceSourceAccessor (&TcpStreamClient::m_sessionEndedTrace),
+                     "ns3::TcpStreamClient::SessionEndedCallback")
   ;
   return tid;
 }
@@ -255,6 +659,7 @@ TcpStreamClient::TcpStreamClient ()
   m_socket = 0;
   m_data = 0;
   m_dataSize = 0;
+  m_videoData = 0;
   state = initial;
 
   m_currentRepIndex = 0;
@@ -266,6 +671,34 @@ TcpStreamClient::TcpStreamClient ()
   m_currentPlaybackIndex = 0;
 
   playbackStarted = 0;
+  m_qoeRegistered = false;
+  m_transportRegistered = false;
+  m_sessionEnded = false;
+  m_underrunStart = 0;
+  m_liveLatency = 0;
+  m_totalBytesReceived = 0;
+  m_playbackRunning = false;
+  m_playbackRate = 1.0;
+  m_requestedPlaybackRate = 0;
+  m_expectedBytes = 0;
+  m_upgradeInProgress = false;
+  m_upgradeSegment = 0;
+  m_upgradeLayer = 0;
+  m_requestAfterUpgrade = false;
+  m_wastedBytes = 0;
+  m_tilesRequested = 0;
+  m_tilesReceived = 0;
+  m_requestsSent = 0;
+  m_audioData = 0;
+  m_audioRequested = 0;
+  m_audioBytesReceived = 0;
+  m_audioDownloadStart = 0;
+  m_videoRequestDeferred = false;
+  m_joinIndex = 0;
+  m_binStart = 0;
+  m_binBytes = 0;
+  m_nextPlaybackTime = Seconds (0);
+  m_requestScheduled = Seconds (0);
   
   m_bufferData.bufferLevelNew.push_back (0);
 }
@@ -273,51 +706,172 @@ TcpStreamClient::TcpStreamClient ()
 void TcpStreamClient::Initialise (std::string algorithm, uint16_t clientId)
 {
   NS_LOG_FUNCTION (this);
-  m_videoData.segmentDuration = m_segmentDuration;
-  if (ReadInBitrateValues (ToString (m_segmentSizeFilePath)) == -1)
-  {
-    NS_LOG_ERROR ("Opening test bitrate file failed. Terminating.\n");
-    Simulator::Stop ();
-    Simulator::Destroy ();
-  }
-  m_lastSegmentIndex = (int64_t) m_videoData.segmentSize.at (0).size ();
-  m_highestRepIndex = m_videoData.averageBitrate.size () - 1;
+  std::string segmentSizeFile = m_segmentSizeFilePath;
+  m_videoId = 0;
+  if (!m_catalogFile.empty ())
+    {
+      const std::vector<std::string> *titles = TcpStreamCatalog::Get ().GetTitles (m_catalogFile);
+      NS_ABORT_MSG_IF (titles == 0, "Opening catalog file " << m_catalogFile << " failed.");
+      if (m_requestedVideoId >= 0)
+        {
+          m_videoId = std::min (m_requestedVideoId, (int64_t) titles->size () - 1);
+        }
+      else
+        {
+          Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+          m_videoId = TcpStreamCatalog::Get ().DrawTitle (titles->size (), m_zipfExponent, uniform->GetValue ());
+        }
+      segmentSizeFile = titles->at (m_videoId);
+      NS_LOG_INFO ("Client " << clientId << " plays video " << m_videoId << " (" << segmentSizeFile << ")");
+    }
+  NS_ABORT_MSG_IF (m_tiledVideo && m_scalableVideo, "A video can't be both tiled and scalable");
+  NS_ABORT_MSG_IF (ReadInBitrateValues (segmentSizeFile) == -1, "Opening test bitrate file " << segmentSizeFile << " failed.");
+  m_lastSegmentIndex = (int64_t) m_videoData->segmentSize.at (0).size ();
+  if (!m_audioSegmentSizeFile.empty ())
+    {
+      m_audioData = TcpStreamCatalog::Get ().GetVideo (m_audioSegmentSizeFile, m_segmentDuration);
+      NS_ABORT_MSG_IF (m_audioData == 0, "Opening audio segment size file " << m_audioSegmentSizeFile << " failed.");
+      m_audioRepIndex = std::min (m_audioRepIndex, (uint32_t) m_audioData->segmentSize.size () - 1);
+      NS_ABORT_MSG_IF (m_audioData->segmentSize.at (m_audioRepIndex).size () < m_videoData->segmentSize.at (0).size (),
+                       "The audio track " << m_audioSegmentSizeFile << " has fewer segments than the video track");
+    }
+  if (m_tiledVideo)
+    {
+      if (m_viewportTraceFile.empty ())
+        {
+          Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+          m_viewport.Generate (m_lastSegmentIndex * m_videoData->segmentDuration, m_viewportSpeed, m_viewportDwell, uniform);
+        }
+      else
+        {
+          NS_ABORT_MSG_IF (!m_viewport.Load (m_viewportTraceFile), "Opening viewport trace file " << m_viewportTraceFile << " failed.");
+        }
+    }
+  m_highestRepIndex = m_videoData->averageBitrate.size () - 1;
+  m_throughput.binDuration = m_binDuration;
+  algo = CreateAlgorithm (algorithm);
+  if (algo == NULL)
+    {
+      NS_LOG_ERROR ("Invalid algorithm name entered. Terminating.");
+      StopApplication ();
+      Simulator::Stop ();
+      Simulator::Destroy ();
+    }
+
+  std::istringstream shadowNames (m_shadowAlgorithms);
+  std::string shadowName;
+  while (std::getline (shadowNames, shadowName, ','))
+    {
+      if (shadowName.empty ())
+        {
+          continue;
+        }
+      AdaptationAlgorithm *shadow = CreateAlgorithm (shadowName);
+      NS_ABORT_MSG_IF (shadow == NULL, "Invalid shadow algorithm name " << shadowName);
+      m_shadowAlgos.push_back (std::make_pair (shadowName, shadow));
+      m_shadowDisagreements.push_back (0);
+    }
+
+  m_algoName = algorithm;
+
+  if (m_fileLogging)
+    {
+      InitializeLogFiles (ToString (m_simulationId), ToString (m_clientId), ToString (m_numberOfClients));
+      if (!m_shadowAlgos.empty ())
+        {
+          std::string sLog = dashLogDirectory + "/SimID_" + ToString (m_simulationId) + "/" + "client" + ToString (m_clientId) + "_" + "shadowLog.txt";
+          shadowLog.open (sLog.c_str ());
+          shadowLog << "Segment_Index Algorithm Rep_Level Primary_Rep_Level Delay Primary_Delay Disagreements\n";
+          shadowLog.flush ();
+        }
+    }
+
+  if (m_qoeSummary)
+    {
+      TcpStreamQoeAggregator::Get ().Register (m_simulationId);
+      m_qoeRegistered = true;
+    }
+}
+
+/**
+ * \brief Apply the attributes of an algorithm created with new, see AdaptationAlgorithm::Construct ().
+ */
+template <typename T>
+static T * ConstructAlgorithm (T *algorithm)
+{
+  algorithm->Construct (T::GetTypeId ());
+  return algorithm;
+}
+
+AdaptationAlgorithm * TcpStreamClient::CreateAlgorithm (std::string algorithm)
+{
+  NS_LOG_FUNCTION (this << algorithm);
+  AdaptationAlgorithm *created = NULL;
   if (algorithm == "tobasco")
     {
-      algo = new TobascoAlgorithm (m_videoData, m_playbackData, m_bufferData, m_throughput);
+      created = ConstructAlgorithm (new TobascoAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
     }
   else if (algorithm == "panda")
     {
-      algo = new PandaAlgorithm (m_videoData, m_playbackData, m_bufferData, m_throughput);
+      created = ConstructAlgorithm (new PandaAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
     }
   else if (algorithm == "festive")
     {
-      algo = new FestiveAlgorithm (m_videoData, m_playbackData, m_bufferData, m_throughput);
+      created = ConstructAlgorithm (new FestiveAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
     }
   else if (algorithm == "simple")
     {
-      algo = new SimpleAlgo (m_videoData, m_playbackData, m_bufferData, m_throughput);
+      created = ConstructAlgorithm (new SimpleAlgo (*m_videoData, m_playbackData, m_bufferData, m_throughput));
     }
   else if (algorithm == "mpc")
     {
-      algo = new MPCAlgo (m_videoData, m_playbackData, m_bufferData, m_throughput);
+      created = ConstructAlgorithm (new MPCAlgo (*m_videoData, m_playbackData, m_bufferData, m_throughput));
     }
   else if (algorithm == "bola")
     {
-      algo = new BolaAlgo (m_videoData, m_playbackData, m_bufferData, m_throughput);
+      created = ConstructAlgorithm (new BolaAlgo (*m_videoData, m_playbackData, m_bufferData, m_throughput));
     }
-  else
+  else if (algorithm == "boladynamic")
     {
-      NS_LOG_ERROR ("Invalid algorithm name entered. Terminating.");
-      StopApplication ();
-      Simulator::Stop ();
-      Simulator::Destroy ();
+      created = ConstructAlgorithm (new BolaAlgo (*m_videoData, m_playbackData, m_bufferData, m_throughput, true));
     }
-
-  m_algoName = algorithm;
-
-  InitializeLogFiles (ToString (m_simulationId), ToString (m_clientId), ToString (m_numberOfClients));
-
+  else if (algorithm == "bba1")
+    {
+      created = ConstructAlgorithm (new Bba1Algorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "bba2")
+    {
+      created = ConstructAlgorithm (new Bba2Algorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "neural")
+    {
+      created = ConstructAlgorithm (new NeuralAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "l2a")
+    {
+      created = ConstructAlgorithm (new L2aAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "lolp")
+    {
+      created = ConstructAlgorithm (new LolpAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "elastic")
+    {
+      created = ConstructAlgorithm (new ElasticAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "tile")
+    {
+      created = ConstructAlgorithm (new TileAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  else if (algorithm == "crosslayer")
+    {
+      created = ConstructAlgorithm (new CrossLayerAlgorithm (*m_videoData, m_playbackData, m_bufferData, m_throughput));
+    }
+  if (created != NULL)
+    {
+      created->SetTransportData (&m_transport);
+    }
+  return created;
 }
 
 TcpStreamClient::~TcpStreamClient ()
@@ -327,6 +881,7 @@ TcpStreamClient::~TcpStreamClient ()
 
   delete algo;
   algo = NULL;
+  DeleteShadows ();
   delete [] m_data;
   m_data = 0;
   m_dataSize = 0;
@@ -337,16 +892,239 @@ void TcpStreamClient::RequestRepIndex ()
   NS_LOG_FUNCTION (this);
   algorithmReply answer;
 
-  answer = algo->GetNextRep ( m_segmentCounter, m_clientId );  
+  MapSegment ();
+  if (m_tiledVideo)
+    {
+      // the viewport is predicted to stay where it is at the playback position
+      m_viewport.GetTileWeights (GetContentIndex (m_currentPlaybackIndex) * m_videoData->segmentDuration,
+                                 m_videoData->tileRows, m_videoData->tileColumns, m_fovYaw, m_fovPitch,
+                                 m_playbackData.tileWeights);
+    }
+  {
+    DASH_PROFILE_SCOPE (profilerScope, ALGORITHM_GET_NEXT_REP, m_algorithmProfiling);
+    answer = algo->GetNextRep ( m_segmentCounter, m_clientId );
+  }
+  if (!m_shadowAlgos.empty ())
+    {
+      EvaluateShadows (answer);
+    }
 
+  if (m_segmentCounter > 0 && answer.nextRepIndex != m_currentRepIndex)
+    {
+      m_representationSwitchedTrace (GetContentIndex (m_segmentCounter), m_currentRepIndex, answer.nextRepIndex);
+    }
   m_currentRepIndex = answer.nextRepIndex;
   NS_ASSERT_MSG (answer.nextRepIndex <= m_highestRepIndex, "The algorithm returned a representation index that's higher than the maximum");
   m_playbackData.playbackIndex.push_back (answer.nextRepIndex);
+  m_bufferedRepIndex.push_back (answer.nextRepIndex);
+  if (m_tiledVideo)
+    {
+      if (answer.tileRepIndex.size () == m_videoData->tileSize.size ())
+        {
+          m_tileRepIndex = answer.tileRepIndex;
+        }
+      else
+        {
+          m_tileRepIndex.assign (m_videoData->tileSize.size (), answer.nextRepIndex);
+        }
+      for (size_t tile = 0; tile < m_tileRepIndex.size (); tile++)
+        {
+          NS_ASSERT_MSG (m_tileRepIndex.at (tile) >= 0 && m_tileRepIndex.at (tile) <= m_highestRepIndex, "The algorithm returned an invalid representation index for tile " << tile);
+        }
+    }
   m_bDelay = answer.nextDownloadDelay;
-  LogAdaptation (answer);
+  m_requestedPlaybackRate = answer.playbackRate;
+  if (m_fileLogging)
+    {
+      LogAdaptation (answer);
+    }
   
 }
 
+void TcpStreamClient::EvaluateShadows (const algorithmReply &answer)
+{
+  NS_LOG_FUNCTION (this);
+  // the shadows see the same history as the primary algorithm, which includes the primary's decisions
+  for (uint32_t i = 0; i < m_shadowAlgos.size (); i++)
+    {
+      algorithmReply shadowAnswer;
+      {
+        DASH_PROFILE_SCOPE (profilerScope, SHADOW_GET_NEXT_REP, m_algorithmProfiling);
+        shadowAnswer = m_shadowAlgos.at (i).second->GetNextRep (m_segmentCounter, m_clientId);
+      }
+      if (shadowAnswer.nextRepIndex != answer.nextRepIndex)
+        {
+          m_shadowDisagreements.at (i)++;
+        }
+      if (m_fileLogging)
+        {
+          shadowLog << GetContentIndex (m_segmentCounter) << " "
+                    << m_shadowAlgos.at (i).first << " "
+                    << shadowAnswer.nextRepIndex << " "
+                    << answer.nextRepIndex << " "
+                    << shadowAnswer.nextDownloadDelay / (double)1000000 << " "
+                    << answer.nextDownloadDelay / (double)1000000 << " "
+                    << m_shadowDisagreements.at (i) << "\n";
+        }
+    }
+  if (m_fileLogging)
+    {
+      shadowLog.flush ();
+    }
+}
+
+void TcpStreamClient::SendRequest ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_audioData != 0 && RequestAudio ())
+    {
+      // sent by AudioReceivedHandle () when the audio segments arrived
+      m_videoRequestDeferred = true;
+      return;
+    }
+  if (m_tiledVideo)
+    {
+      // one request per tile, pipelined, the tiles arrive in request order
+      int64_t contentIndex = GetContentIndex (m_segmentCounter);
+      int64_t tiles = m_videoData->tileSize.size ();
+      m_tileEnd.assign (tiles, 0);
+      for (int64_t tile = 0; tile < tiles; tile++)
+        {
+          m_tileEnd.at (tile) = (tile > 0 ? m_tileEnd.at (tile - 1) : 0)
+            + m_videoData->tileSize.at (tile).at (m_tileRepIndex.at (tile)).at (contentIndex);
+        }
+      m_expectedBytes = m_tileEnd.back ();
+      m_tileRequestSent.assign (tiles, 0);
+      m_tilesRequested = 0;
+      m_tilesReceived = 0;
+      if (m_fileLogging)
+        {
+          m_viewport.GetTileWeights (contentIndex * m_videoData->segmentDuration + m_videoData->segmentDuration / 2,
+                                     m_videoData->tileRows, m_videoData->tileColumns, m_fovYaw, m_fovPitch, m_viewportWeights);
+        }
+      int64_t depth = m_pipelineDepth == 0 ? tiles : std::min ((int64_t) m_pipelineDepth, tiles);
+      while (m_tilesRequested < depth)
+        {
+          SendTileRequest ();
+        }
+      return;
+    }
+  // the server returns the requested number of bytes, the video id is for its per title statistics
+  m_expectedBytes = GetSegmentSize (m_currentRepIndex, m_segmentCounter);
+  std::string request = ToString (m_expectedBytes) + " " + ToString (m_videoId);
+  Send (request);
+}
+
+bool TcpStreamClient::RequestAudio ()
+{
+  NS_LOG_FUNCTION (this);
+  // segments requested ahead were mapped to content indices by guess, after a skip they belong to other video segments
+  for (int64_t i = m_segmentCounter; i < m_audioRequested; i++)
+    {
+      if (m_audioContentIndex.at (i) != GetContentIndex (i))
+        {
+          m_audioContentIndex.resize (i);
+          m_audioRequested = i;
+          break;
+        }
+    }
+  const std::vector<int64_t> &sizes = m_audioData->segmentSize.at (m_audioRepIndex);
+  int64_t now = Simulator::Now ().GetMicroSeconds ();
+  while (m_audioRequested <= m_segmentCounter + (int64_t) m_audioLead
+         && GetContentIndex (m_audioRequested) < (int64_t) sizes.size ()
+         && getAvailabilityTime (m_audioRequested) <= now
+         && (m_audioPipelining || m_audioRequests.empty ()))
+    {
+      int64_t contentIndex = GetContentIndex (m_audioRequested);
+      int64_t bytes = sizes.at (contentIndex);
+      std::string request = ToString (bytes) + " " + ToString (m_videoId);
+      Send (request);
+      m_audioRequests.push_back (bytes);
+      m_audioRequestSent.push_back (m_downloadRequestSent);
+      m_audioRequestContent.push_back (contentIndex);
+      m_audioContentIndex.push_back (contentIndex);
+      m_audioRequested++;
+    }
+  return !m_audioPipelining && !m_audioRequests.empty ();
+}
+
+uint32_t TcpStreamClient::ReceiveAudio (uint32_t bytes)
+{
+  NS_LOG_FUNCTION (this << bytes);
+  uint32_t consumed = 0;
+  while (consumed < bytes && !m_audioRequests.empty ())
+    {
+      if (m_audioBytesReceived == 0)
+        {
+          m_audioDownloadStart = Simulator::Now ().GetMicroSeconds ();
+        }
+      int64_t part = std::min ((int64_t)(bytes - consumed), m_audioRequests.front () - m_audioBytesReceived);
+      m_audioBytesReceived += part;
+      consumed += part;
+      if (m_audioBytesReceived == m_audioRequests.front ())
+        {
+          AudioReceivedHandle ();
+        }
+    }
+  return consumed;
+}
+
+void TcpStreamClient::AudioReceivedHandle ()
+{
+  NS_LOG_FUNCTION (this);
+  AdvancePlayback (Simulator::Now ());
+  int64_t contentIndex = m_audioRequestContent.front ();
+  if (m_currentPlaybackIndex == 0 || contentIndex > GetContentIndex (m_currentPlaybackIndex - 1))
+    {
+      m_audioBuffered.insert (contentIndex);
+    }
+  if (m_fileLogging)
+    {
+      LogAudio ();
+    }
+  m_audioRequests.pop_front ();
+  m_audioRequestSent.pop_front ();
+  m_audioRequestContent.pop_front ();
+  m_audioBytesReceived = 0;
+  if (state == terminal)
+    {
+      return;
+    }
+  if (m_videoRequestDeferred && m_audioRequests.empty ())
+    {
+      // the next audio segment, if one is due, or the video segment
+      m_videoRequestDeferred = false;
+      SendRequest ();
+    }
+  SchedulePlaybackEvent ();
+}
+
+void TcpStreamClient::SendTileRequest ()
+{
+  NS_LOG_FUNCTION (this);
+  int64_t tile = m_tilesRequested++;
+  int64_t bytes = m_tileEnd.at (tile) - (tile > 0 ? m_tileEnd.at (tile - 1) : 0);
+  std::string request = ToString (bytes) + " " + ToString (m_videoId);
+  Send (request);
+  m_tileRequestSent.at (tile) = m_downloadRequestSent;
+  // the segment counts as requested with its first tile
+  m_downloadRequestSent = m_tileRequestSent.at (0);
+}
+
+void TcpStreamClient::TileReceivedHandle ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fileLogging)
+    {
+      LogTile ();
+    }
+  m_tilesReceived++;
+  if (m_tilesRequested < (int64_t) m_tileEnd.size ())
+    {
+      SendTileRequest ();
+    }
+}
+
 template <typename T>
 void TcpStreamClient::Send (T & message)
 {
@@ -355,24 +1133,61 @@ void TcpStreamClient::Send (T & message)
   Ptr<Packet> p;
   p = Create<Packet> (m_data, m_dataSize);
   m_downloadRequestSent = Simulator::Now ().GetMicroSeconds ();
+  m_requestsSent++;
   m_socket->Send (p);
 }
 
 void TcpStreamClient::HandleRead (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
+  DASH_PROFILE_SCOPE (profilerScope, CLIENT_HANDLE_READ, m_profiling);
   Ptr<Packet> packet;
-  if (m_bytesReceived == 0)
-    {
-      m_transmissionStartReceivingSegment = Simulator::Now ().GetMicroSeconds ();
-    }
+  int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
   uint32_t packetSize;
   while ( (packet = socket->Recv ()) )
     {
       packetSize = packet->GetSize ();
+      DASH_PROFILE_BYTES (profilerScope, packetSize);
+      m_totalBytesReceived += packetSize;
+      if (!m_audioRequests.empty ())
+        {
+          // the audio segments were requested before the video segment, their bytes come first
+          packetSize -= ReceiveAudio (packetSize);
+          if (packetSize == 0)
+            {
+              continue;
+            }
+        }
+      if (m_bytesReceived == 0 && !m_upgradeInProgress)
+        {
+          m_transmissionStartReceivingSegment = timeNow;
+          m_binStart = timeNow;
+          m_binBytes = 0;
+        }
       m_bytesReceived += packetSize;
-      if (m_bytesReceived == m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter))
+      if (m_upgradeInProgress)
+        {
+          // enhancement layers are not part of the segment throughput the algorithms see
+          if (m_bytesReceived == m_expectedBytes)
+            {
+              UpgradeReceivedHandle ();
+            }
+          continue;
+        }
+      if (m_binDuration > 0)
+        {
+          SampleThroughput (timeNow, packetSize);
+        }
+      while (m_tilesReceived < (int64_t) m_tileEnd.size () && m_bytesReceived >= m_tileEnd.at (m_tilesReceived))
+        {
+          TileReceivedHandle ();
+        }
+      if (m_bytesReceived == m_expectedBytes)
         {
+          if (m_binDuration > 0)
+            {
+              CloseThroughputBin (timeNow);
+            }
           SegmentReceivedHandle ();
         }
     }
@@ -381,27 +1196,18 @@ void TcpStreamClient::HandleRead (Ptr<Socket> socket)
 int TcpStreamClient::ReadInBitrateValues (std::string segmentSizeFile)
 {
   NS_LOG_FUNCTION (this);
-  std::ifstream myfile;
-  myfile.open (segmentSizeFile.c_str ());
-  if (!myfile)
+  if (m_tiledVideo)
     {
-      return -1;
+      m_videoData = TcpStreamCatalog::Get ().GetTiledVideo (segmentSizeFile, m_segmentDuration);
     }
-  std::string temp;
-  while (std::getline (myfile, temp))
+  else
     {
-      if (temp.empty ())
-        {
-          break;
-        }
-      std::istringstream buffer (temp);
-      std::vector<int64_t> line ((std::istream_iterator<int64_t> (buffer)),
-                                 std::istream_iterator<int64_t>());
-	    m_videoData.averageBitrate.push_back(line.at(0));
-	    line.erase(line.begin());
-      m_videoData.segmentSize.push_back (line);
+      m_videoData = TcpStreamCatalog::Get ().GetVideo (segmentSizeFile, m_segmentDuration, m_scalableVideo);
+    }
+  if (m_videoData == 0)
+    {
+      return -1;
     }
-  NS_ASSERT_MSG (!m_videoData.segmentSize.empty (), "No segment sizes read from file.");
   return 1;
 }
 
@@ -410,72 +1216,190 @@ void TcpStreamClient::SegmentReceivedHandle ()
   NS_LOG_FUNCTION (this);
   
   m_transmissionEndReceivingSegment = Simulator::Now ().GetMicroSeconds (); 
+  AdvancePlayback (Simulator::Now ());
 
   //Update the current buffer level by calculating elapsed playback time
   if (m_segmentCounter > 0 && playbackStarted == 1) {
     
-    int64_t elapsedPlaybackTime = m_bufferData.bufferLevelNew.back () - (m_transmissionEndReceivingSegment - m_bufferData.timeNow.back ());
+    int64_t elapsedPlaybackTime = m_bufferData.bufferLevelNew.back () - (int64_t)((m_transmissionEndReceivingSegment - m_bufferData.timeNow.back ()) * m_playbackRate.Get ());
     m_bufferData.bufferLevelNew.push_back (std::max (elapsedPlaybackTime, (int64_t) 0));
     
   }
   
   //Add the downloaded segment to the buffer
   if(m_segmentCounter == 0) {
-    m_bufferData.bufferLevelNew.push_back (m_videoData.segmentDuration);
+    m_bufferData.bufferLevelNew.push_back (m_videoData->segmentDuration);
   } else {
-    m_bufferData.bufferLevelNew.push_back (m_bufferData.bufferLevelNew.back () + m_videoData.segmentDuration);
+    m_bufferData.bufferLevelNew.push_back (m_bufferData.bufferLevelNew.back () + m_videoData->segmentDuration);
   }
   m_bufferData.timeNow.push_back (m_transmissionEndReceivingSegment);
   
-  m_throughput.bytesReceived.push_back (m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter));
+  m_throughput.bytesReceived.push_back (m_expectedBytes);
   m_throughput.transmissionStart.push_back (m_transmissionStartReceivingSegment);
   m_throughput.transmissionRequested.push_back (m_downloadRequestSent);
   m_throughput.transmissionEnd.push_back (m_transmissionEndReceivingSegment);
 
   m_segmentsInBuffer++;
+  TcpStreamProfiler::AddSegment (m_throughput.bytesReceived.back ());
   
-  LogDownload ();
-  LogThroughput (0);
-  LogBuffer ();
+  m_segmentDownloadedTrace (GetContentIndex (m_segmentCounter), m_currentRepIndex, m_throughput.bytesReceived.back (),
+                            m_downloadRequestSent, m_transmissionStartReceivingSegment, m_transmissionEndReceivingSegment);
+  m_bufferLevelTrace (m_bufferData.bufferLevelNew.back (), m_segmentsInBuffer);
+  if (m_fileLogging)
+    {
+      LogDownload ();
+      LogThroughput (0);
+      LogBuffer ();
+    }
   
   m_bytesReceived = 0;
   if (m_segmentCounter == m_lastSegmentIndex)
     {
       m_bDelay = 0;
     }
+  else if (m_maxBuffer > 0)
+    {
+      // do not request the next segment before it fits into the buffer
+      m_bDelay = std::max (m_bDelay, m_bufferData.bufferLevelNew.back () + (int64_t) m_videoData->segmentDuration - (int64_t) m_maxBuffer);
+    }
  
   controllerEvent event = downloadFinished;
   Controller (event);
   
 }
 
-bool TcpStreamClient::PlaybackHandle ()
+void TcpStreamClient::StartUpgrade ()
 {
   NS_LOG_FUNCTION (this);
+  if (!m_scalableVideo || m_upgradeInProgress || state != playing || !m_playbackRunning
+      || m_socket == 0 || m_throughput.bytesReceived.empty ())
+    {
+      return;
+    }
+  int64_t duration = m_throughput.transmissionEnd.back () - m_throughput.transmissionRequested.back ();
+  if (duration <= 0)
+    {
+      return;
+    }
+  // bytes per microsecond
+  double rate = m_throughput.bytesReceived.back () / (double) duration;
   int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  int64_t playbackDuration = GetPlaybackDuration ().GetMicroSeconds ();
+  int64_t segment = -1;
+  for (int64_t k = m_currentPlaybackIndex; k < m_currentPlaybackIndex + m_segmentsInBuffer; k++)
+    {
+      int64_t layer = m_bufferedRepIndex.at (k);
+      if (layer >= m_currentRepIndex || (segment >= 0 && layer >= m_bufferedRepIndex.at (segment)))
+        {
+          continue;
+        }
+      int64_t bytes = GetSegmentSize (layer + 1, k) - GetSegmentSize (layer, k);
+      int64_t deadline = m_nextPlaybackTime.GetMicroSeconds () + (k - m_currentPlaybackIndex) * playbackDuration;
+      if (bytes > 0 && timeNow + (int64_t)(bytes / rate) + (int64_t) m_upgradeMargin <= deadline)
+        {
+          segment = k;
+        }
+    }
+  if (segment < 0)
+    {
+      return;
+    }
+  m_upgradeInProgress = true;
+  m_upgradeSegment = segment;
+  m_upgradeLayer = m_bufferedRepIndex.at (segment) + 1;
+  m_expectedBytes = GetSegmentSize (m_upgradeLayer, segment) - GetSegmentSize (m_upgradeLayer - 1, segment);
+  std::string request = ToString (m_expectedBytes) + " " + ToString (m_videoId);
+  Send (request);
+}
+
+void TcpStreamClient::UpgradeReceivedHandle ()
+{
+  NS_LOG_FUNCTION (this);
+  AdvancePlayback (Simulator::Now ());
+  m_bytesReceived = 0;
+  m_upgradeInProgress = false;
+  bool used = m_upgradeSegment >= m_currentPlaybackIndex;
+  if (used)
+    {
+      m_bufferedRepIndex.at (m_upgradeSegment) = m_upgradeLayer;
+    }
+  else
+    {
+      m_wastedBytes += m_expectedBytes;
+    }
+  if (m_fileLogging)
+    {
+      LogUpgrade (used);
+    }
+  if (state == terminal)
+    {
+      return;
+    }
+  if (m_requestAfterUpgrade)
+    {
+      m_requestAfterUpgrade = false;
+      controllerEvent event = irdFinished;
+      Controller (event);
+      return;
+    }
+  StartUpgrade ();
+  SchedulePlaybackEvent ();
+}
+
+bool TcpStreamClient::PlaybackHandle (int64_t timeNow)
+{
+  NS_LOG_FUNCTION (this << timeNow);
   if(playbackStarted == 0) {
     playbackStarted = 1;
-    m_bufferData.timeNow.push_back (Simulator::Now ().GetMicroSeconds ());
+    m_bufferData.timeNow.push_back (timeNow);
   } 
 
   // if we got called and there are no segments left in the buffer, there is a buffer underrun
-  if (m_segmentsInBuffer == 0 && m_currentPlaybackIndex < m_lastSegmentIndex && !m_bufferUnderrun)
+  if (GetPlayableSegments () == 0 && m_currentPlaybackIndex < m_lastSegmentIndex && !m_bufferUnderrun)
     {
       m_bufferUnderrun = true;
-      bufferUnderrunLog << std::setfill (' ') << std::setw (26) << timeNow / (double)1000000 << " ";
-      bufferUnderrunLog.flush ();
+      m_underrunStart = timeNow;
+      if (m_fileLogging)
+        {
+          bufferUnderrunLog << std::setfill (' ') << std::setw (26) << timeNow / (double)1000000 << " ";
+          bufferUnderrunLog.flush ();
+        }
+      m_qoe.OnStallStarted (timeNow);
+      m_stallStartedTrace (GetContentIndex (m_currentPlaybackIndex));
       return true;
     }
-  else if (m_segmentsInBuffer > 0)
+  else if (GetPlayableSegments () > 0)
     {
       if (m_bufferUnderrun)
       {
         m_bufferUnderrun = false;
-        bufferUnderrunLog << std::setfill (' ') << std::setw (13) << timeNow / (double)1000000 << "\n";
-        bufferUnderrunLog.flush ();
+        if (m_fileLogging)
+          {
+            bufferUnderrunLog << std::setfill (' ') << std::setw (13) << timeNow / (double)1000000 << "\n";
+            bufferUnderrunLog.flush ();
+          }
+        m_qoe.OnStallEnded (timeNow);
+        m_stallEndedTrace (GetContentIndex (m_currentPlaybackIndex), timeNow - m_underrunStart);
       }
       m_playbackData.playbackStart.push_back (timeNow);
-      LogPlayback ();
+      if (m_fileLogging)
+        {
+          LogPlayback (timeNow);
+        }
+      int64_t repIndex = m_bufferedRepIndex.at (m_currentPlaybackIndex);
+      int64_t liveLatency = timeNow - (int64_t)(getAvailabilityTime (m_currentPlaybackIndex) - m_videoData->segmentDuration);
+      UpdatePlaybackRate (liveLatency);
+      m_playbackData.liveLatency.push_back (liveLatency);
+      m_playbackData.playbackRate.push_back (m_playbackRate.Get ());
+      m_qoe.OnPlayback (timeNow, repIndex,
+                        GetSegmentSize (repIndex, m_currentPlaybackIndex) * 8 / (m_videoData->segmentDuration / (double)1000000),
+                        m_videoData->segmentDuration, liveLatency);
+      m_liveLatency = liveLatency;
+      m_playbackStartedTrace (GetContentIndex (m_currentPlaybackIndex), repIndex, liveLatency, timeNow);
+      if (m_audioData != 0)
+        {
+          m_audioBuffered.erase (m_audioBuffered.begin (), m_audioBuffered.upper_bound (GetContentIndex (m_currentPlaybackIndex)));
+        }
       m_segmentsInBuffer--;
       m_currentPlaybackIndex++;
       return false;
@@ -505,15 +1429,104 @@ void TcpStreamClient::SetRemote (Ipv6Address ip, uint16_t port)
   m_peerPort = port;
 }
 
+int64_t TcpStreamClient::GetBufferLevel () const
+{
+  if (!playbackStarted)
+    {
+      return m_bufferData.bufferLevelNew.back ();
+    }
+  if (m_bufferUnderrun)
+    {
+      return 0;
+    }
+  int64_t elapsed = (int64_t)((Simulator::Now ().GetMicroSeconds () - m_bufferData.timeNow.back ()) * m_playbackRate.Get ());
+  return std::max (m_bufferData.bufferLevelNew.back () - elapsed, (int64_t) 0);
+}
+
+int64_t TcpStreamClient::GetPendingPlaybacks (Time timeNow) const
+{
+  if (!m_playbackRunning || timeNow < m_nextPlaybackTime || IsWaitingForResume ())
+    {
+      return 0;
+    }
+  int64_t due = (timeNow - m_nextPlaybackTime).GetTimeStep () / GetPlaybackDuration ().GetTimeStep () + 1;
+  return std::min (due, GetPlayableSegments ());
+}
+
+int64_t TcpStreamClient::GetPlaybackRepIndex () const
+{
+  int64_t playbackIndex = m_currentPlaybackIndex + GetPendingPlaybacks (Simulator::Now ());
+  if (playbackIndex == 0)
+    {
+      return 0;
+    }
+  return m_bufferedRepIndex.at (playbackIndex - 1);
+}
+
+int64_t TcpStreamClient::GetLiveLatency () const
+{
+  int64_t pending = GetPendingPlaybacks (Simulator::Now ());
+  if (pending == 0)
+    {
+      return m_liveLatency;
+    }
+  int64_t playbackIndex = m_currentPlaybackIndex + pending - 1;
+  int64_t playbackTime = (m_nextPlaybackTime + MicroSeconds ((pending - 1) * m_videoData->segmentDuration)).GetMicroSeconds ();
+  return playbackTime - (int64_t)(getAvailabilityTime (playbackIndex) - m_videoData->segmentDuration);
+}
+
+uint64_t TcpStreamClient::GetTotalBytesReceived () const
+{
+  return m_totalBytesReceived;
+}
+
+uint64_t TcpStreamClient::GetWastedBytes () const
+{
+  return m_wastedBytes;
+}
+
+uint64_t TcpStreamClient::GetRequestsSent () const
+{
+  return m_requestsSent;
+}
+
+bool TcpStreamClient::IsStreaming () const
+{
+  return m_socket != 0;
+}
+
 void TcpStreamClient::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  ReportQoe ();
+  Simulator::Cancel (m_playbackEvent);
+  Simulator::Cancel (m_requestEvent);
+  UnregisterTransport ();
+  m_socket = 0;
+  // release the per segment data, a disposed client stays attached to its node
+  delete algo;
+  algo = NULL;
+  DeleteShadows ();
+  m_videoData = 0;
+  m_audioData = 0;
+  m_playbackData = playbackData ();
+  m_bufferData = bufferData ();
+  m_throughput = throughputData ();
+  m_transport = transportData ();
+  std::vector<int64_t> ().swap (m_audioContentIndex);
+  m_audioBuffered.clear ();
   Application::DoDispose ();
 }
 
 void TcpStreamClient::StartApplication (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_profiling || m_algorithmProfiling)
+    {
+      TcpStreamProfiler::ScheduleDump ();
+    }
+  m_qoe.OnSessionStart (m_clientId, Simulator::Now ().GetMicroSeconds ());
+  JoinLiveStream ();
   if (m_socket == 0)
     {
       TypeId tid = TypeId::LookupByName ("ns3::TcpSocketFactory");
@@ -543,12 +1556,56 @@ void TcpStreamClient::StopApplication ()
       m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
       m_socket = 0;
     }
+  UnregisterTransport ();
+  Simulator::Cancel (m_playbackEvent);
+  Simulator::Cancel (m_requestEvent);
   downloadLog.close ();
   playbackLog.close ();
   adaptationLog.close ();
   bufferLog.close ();
   throughputLog.close ();
   bufferUnderrunLog.close ();
+  shadowLog.close ();
+  throughputBinLog.close ();
+  layerLog.close ();
+  tileLog.close ();
+  audioLog.close ();
+  ReportQoe ();
+  if (!m_sessionEnded)
+    {
+      m_sessionEnded = true;
+      m_sessionEndedTrace (m_clientId);
+    }
+}
+
+void TcpStreamClient::DeleteShadows ()
+{
+  for (uint32_t i = 0; i < m_shadowAlgos.size (); i++)
+    {
+      delete m_shadowAlgos.at (i).second;
+    }
+  m_shadowAlgos.clear ();
+  m_shadowDisagreements.clear ();
+}
+
+void TcpStreamClient::UnregisterTransport ()
+{
+  if (m_transportRegistered)
+    {
+      m_transportRegistered = false;
+      TcpStreamTransportRegistry::Get ().Unregister (m_transportAddress);
+    }
+}
+
+void TcpStreamClient::ReportQoe ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_qoeRegistered)
+    {
+      m_qoeRegistered = false;
+      m_qoe.Finish (Simulator::Now ().GetMicroSeconds ());
+      TcpStreamQoeAggregator::Get ().Report (m_qoe.GetMetrics ());
+    }
 }
 
 
@@ -574,6 +1631,12 @@ void TcpStreamClient::ConnectionSucceeded (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
   NS_LOG_LOGIC ("Tcp Stream Client connection succeeded");
+  // the server sees our local address as peer address of its socket
+  if (socket->GetSockName (m_transportAddress) == 0)
+    {
+      TcpStreamTransportRegistry::Get ().Register (m_transportAddress, &m_transport);
+      m_transportRegistered = true;
+    }
   controllerEvent event = init;
   Controller (event);
 }
@@ -588,19 +1651,65 @@ void TcpStreamClient::LogThroughput (uint32_t packetSize)
 {
   NS_LOG_FUNCTION (this);
   throughputLog << Simulator::Now ().GetMicroSeconds ()  / (double) 1000000 << " "
-                << std::to_string((m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter)*8)/((m_transmissionEndReceivingSegment-m_transmissionStartReceivingSegment)/(double)1000000)) << "\n";
+                << std::to_string((m_expectedBytes*8)/((m_transmissionEndReceivingSegment-m_transmissionStartReceivingSegment)/(double)1000000)) << "\n";
   throughputLog.flush ();
   
 }
 
+void TcpStreamClient::SampleThroughput (int64_t timeNow, uint32_t packetSize)
+{
+  int64_t binDuration = m_binDuration;
+  if (timeNow >= m_binStart + binDuration)
+    {
+      CloseThroughputBin (m_binStart + binDuration);
+      // bins without any packet, only the last m_binCapacity of them can stay in the ring buffer
+      int64_t emptyBins = (timeNow - m_binStart) / binDuration;
+      int64_t skipped = std::max ((int64_t) 0, emptyBins - (int64_t) m_binCapacity);
+      m_binStart += skipped * binDuration;
+      for (int64_t i = skipped; i < emptyBins; i++)
+        {
+          CloseThroughputBin (m_binStart + binDuration);
+        }
+    }
+  m_binBytes += packetSize;
+}
+
+void TcpStreamClient::CloseThroughputBin (int64_t binEnd)
+{
+  uint32_t slot = m_throughput.binsWritten % m_binCapacity;
+  if (m_throughput.binStart.size () < m_binCapacity)
+    {
+      m_throughput.binStart.push_back (m_binStart);
+      m_throughput.binLength.push_back (binEnd - m_binStart);
+      m_throughput.binBytes.push_back (m_binBytes);
+      m_throughput.binSegment.push_back (GetContentIndex (m_segmentCounter));
+    }
+  else
+    {
+      m_throughput.binStart.at (slot) = m_binStart;
+      m_throughput.binLength.at (slot) = binEnd - m_binStart;
+      m_throughput.binBytes.at (slot) = m_binBytes;
+      m_throughput.binSegment.at (slot) = GetContentIndex (m_segmentCounter);
+    }
+  m_throughput.binsWritten++;
+  if (m_fileLogging && binEnd > m_binStart)
+    {
+      throughputBinLog << m_binStart / (double) 1000000 << " " << binEnd / (double) 1000000 << " "
+                       << m_binBytes << " " << m_binBytes * 8 / ((binEnd - m_binStart) / (double) 1000000) << " "
+                       << GetContentIndex (m_segmentCounter) << "\n";
+    }
+  m_binStart = binEnd;
+  m_binBytes = 0;
+}
+
 void TcpStreamClient::LogDownload ()
 {
   NS_LOG_FUNCTION (this);
-  downloadLog <<  m_segmentCounter << " "
+  downloadLog <<  GetContentIndex (m_segmentCounter) << " "
               <<  m_downloadRequestSent / (double)1000000 << " "
               <<  m_transmissionStartReceivingSegment / (double)1000000 << " "
               <<  m_transmissionEndReceivingSegment / (double)1000000 << " "
-              <<  m_videoData.segmentSize.at (m_currentRepIndex).at (m_segmentCounter) << " "
+              <<  m_expectedBytes << " "
               <<  "\n";
   downloadLog.flush ();
 
@@ -617,29 +1726,70 @@ void TcpStreamClient::LogBuffer ()
 void TcpStreamClient::LogAdaptation (algorithmReply answer)
 {
   NS_LOG_FUNCTION (this);
- adaptationLog << m_segmentCounter << " "
+ adaptationLog << GetContentIndex (m_segmentCounter) << " "
                 << m_currentRepIndex << " "
                 << answer.decisionTime / (double)1000000 << " "
                 << answer.decisionCase << " "
                 << answer.nextDownloadDelay/ (double)1000000 << " "
                 << answer.delayDecisionCase << " "
-                << std::to_string(answer.bandwidthEstimate) << "\n";
+                << std::to_string(answer.bandwidthEstimate) << " "
+                << algo->GetPredictionError () << "\n";
   adaptationLog.flush ();
 
 }
 
-void TcpStreamClient::LogPlayback ()
+void TcpStreamClient::LogPlayback (int64_t playbackTime)
 {
   NS_LOG_FUNCTION (this);
   double becameAvailable = getAvailabilityTime(m_currentPlaybackIndex);
-  playbackLog << m_currentPlaybackIndex << " "
+  playbackLog << GetContentIndex (m_currentPlaybackIndex) << " "
               <<  ((becameAvailable)/ (double)1000000) << " "
-              <<  std::to_string(Simulator::Now ().GetMicroSeconds ()  / (double)1000000) << " "
-              <<  std::to_string((Simulator::Now ().GetMicroSeconds ()-(becameAvailable-m_videoData.segmentDuration))  / (double)1000000) << " "
-              << m_playbackData.playbackIndex.at (m_currentPlaybackIndex) << "\n";
+              <<  std::to_string(playbackTime  / (double)1000000) << " "
+              <<  std::to_string((playbackTime-(becameAvailable-m_videoData->segmentDuration))  / (double)1000000) << " "
+              << m_bufferedRepIndex.at (m_currentPlaybackIndex) << "\n";
   playbackLog.flush ();
 }
 
+void TcpStreamClient::LogUpgrade (bool used)
+{
+  NS_LOG_FUNCTION (this);
+  layerLog << GetContentIndex (m_upgradeSegment) << " "
+           << m_upgradeLayer << " "
+           << m_expectedBytes << " "
+           << m_downloadRequestSent / (double)1000000 << " "
+           << Simulator::Now ().GetMicroSeconds () / (double)1000000 << " "
+           << used << "\n";
+  layerLog.flush ();
+}
+
+void TcpStreamClient::LogAudio ()
+{
+  NS_LOG_FUNCTION (this);
+  audioLog << m_audioRequestContent.front () << " "
+           << m_audioRepIndex << " "
+           << m_audioRequests.front () << " "
+           << m_audioRequestSent.front () / (double)1000000 << " "
+           << m_audioDownloadStart / (double)1000000 << " "
+           << Simulator::Now ().GetMicroSeconds () / (double)1000000 << " "
+           << m_audioBuffered.size () << " "
+           << m_segmentsInBuffer << "\n";
+  audioLog.flush ();
+}
+
+void TcpStreamClient::LogTile ()
+{
+  NS_LOG_FUNCTION (this);
+  int64_t tile = m_tilesReceived;
+  tileLog << GetContentIndex (m_segmentCounter) << " "
+          << tile << " "
+          << m_tileRepIndex.at (tile) << " "
+          << m_tileEnd.at (tile) - (tile > 0 ? m_tileEnd.at (tile - 1) : 0) << " "
+          << m_tileRequestSent.at (tile) / (double)1000000 << " "
+          << Simulator::Now ().GetMicroSeconds () / (double)1000000 << " "
+          << m_playbackData.tileWeights.at (tile) << " "
+          << m_viewportWeights.at (tile) << "\n";
+}
+
 void TcpStreamClient::InitializeLogFiles (std::string simulationId, std::string clientId, std::string numberOfClients)
 {
   NS_LOG_FUNCTION (this);
@@ -656,7 +1806,7 @@ void TcpStreamClient::InitializeLogFiles (std::string simulationId, std::string
 
   std::string aLog = dashLogDirectory + "/SimID_" + simulationId + "/" + "client" + clientId + "_" + "adaptationLog.txt";
   adaptationLog.open (aLog.c_str ());
-  adaptationLog << "Segment_Index Rep_Level Decision_Point_Of_Time Case Delay DelayCase BandwidthEstimate\n";
+  adaptationLog << "Segment_Index Rep_Level Decision_Point_Of_Time Case Delay DelayCase BandwidthEstimate Prediction_Error\n";
   adaptationLog.flush ();
 
   std::string bLog = dashLogDirectory + "/SimID_" + simulationId + "/" + "client" + clientId + "_" + "bufferLog.txt";
@@ -673,11 +1823,109 @@ void TcpStreamClient::InitializeLogFiles (std::string simulationId, std::string
   bufferUnderrunLog.open (buLog.c_str ());
   bufferUnderrunLog << ("Buffer_Underrun_Started_At         Until \n");
   bufferUnderrunLog.flush ();
+
+  if (m_binDuration > 0)
+    {
+      // written once per bin without flushing, the file is flushed when the client stops
+      std::string tbLog = dashLogDirectory + "/SimID_" + simulationId + "/" + "client" + clientId + "_" + "throughputBinLog.txt";
+      throughputBinLog.open (tbLog.c_str ());
+      throughputBinLog << "Bin_Start Bin_End Bytes Throughput Segment_Index\n";
+      throughputBinLog.flush ();
+    }
+
+  if (m_scalableVideo)
+    {
+      std::string lLog = dashLogDirectory + "/SimID_" + simulationId + "/" + "client" + clientId + "_" + "layerLog.txt";
+      layerLog.open (lLog.c_str ());
+      layerLog << "Segment_Index Layer Bytes Request_Sent Download_End Used\n";
+      layerLog.flush ();
+    }
+
+  if (!m_audioSegmentSizeFile.empty ())
+    {
+      std::string auLog = dashLogDirectory + "/SimID_" + simulationId + "/" + "client" + clientId + "_" + "audioLog.txt";
+      audioLog.open (auLog.c_str ());
+      audioLog << "Segment_Index Rep_Level Bytes Download_Request_Sent Download_Start Download_End Audio_Segments_In_Buffer Video_Segments_In_Buffer\n";
+      audioLog.flush ();
+    }
+
+  if (m_tiledVideo)
+    {
+      // written once per tile without flushing, the file is flushed when the client stops
+      std::string tiLog = dashLogDirectory + "/SimID_" + simulationId + "/" + "client" + clientId + "_" + "tileLog.txt";
+      tileLog.open (tiLog.c_str ());
+      tileLog << "Segment_Index Tile Rep_Level Bytes Request_Sent Download_End Predicted_Weight Viewport_Weight\n";
+      tileLog.flush ();
+    }
 }
   
-double TcpStreamClient::getAvailabilityTime(int64_t segmentIndex)
+double TcpStreamClient::getAvailabilityTime(int64_t segmentIndex) const
 {
-  return (double)m_videoData.segmentDuration*segmentIndex;
+  return (double)m_liveStart + (double)m_videoData->segmentDuration*GetContentIndex (segmentIndex);
 }
-  
-} // Namespace ns3
\ No newline at end of file
+
+int64_t TcpStreamClient::GetContentIndex (int64_t segmentIndex) const
+{
+  const std::vector<int64_t> &contentIndex = m_playbackData.contentIndex;
+  if (segmentIndex < (int64_t) contentIndex.size ())
+    {
+      return contentIndex.at (segmentIndex);
+    }
+  // not requested yet, the segments follow the last requested one
+  int64_t next = contentIndex.empty () ? m_joinIndex : contentIndex.back () + 1;
+  return next + segmentIndex - (int64_t) contentIndex.size ();
+}
+
+int64_t TcpStreamClient::GetSegmentSize (int64_t repIndex, int64_t segmentIndex) const
+{
+  return m_videoData->segmentSize.at (repIndex).at (GetContentIndex (segmentIndex));
+}
+
+void TcpStreamClient::MapSegment ()
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<int64_t> &contentIndex = m_playbackData.contentIndex;
+  while ((int64_t) contentIndex.size () <= m_segmentCounter)
+    {
+      contentIndex.push_back (GetContentIndex (contentIndex.size ()));
+    }
+  if (m_dvrWindow == 0)
+    {
+      return;
+    }
+  // segments that left the DVR window can't be requested anymore, continue with the oldest one still available
+  int64_t now = Simulator::Now ().GetMicroSeconds ();
+  int64_t segmentDuration = m_videoData->segmentDuration;
+  int64_t expired = now - (int64_t) m_liveStart - (int64_t) m_dvrWindow;
+  int64_t oldest = expired > 0 ? (expired + segmentDuration - 1) / segmentDuration : 0;
+  oldest = std::min (oldest, (int64_t) m_videoData->segmentSize.at (0).size () - 1);
+  int64_t skipped = oldest - contentIndex.at (m_segmentCounter);
+  if (skipped > 0)
+    {
+      NS_LOG_INFO ("Client " << m_clientId << " skips " << skipped << " expired segments");
+      contentIndex.at (m_segmentCounter) = oldest;
+      m_lastSegmentIndex -= skipped;
+    }
+}
+
+void TcpStreamClient::JoinLiveStream ()
+{
+  NS_LOG_FUNCTION (this);
+  int64_t segmentCount = m_videoData->segmentSize.at (0).size ();
+  m_joinIndex = 0;
+  if (m_joinAtLiveEdge)
+    {
+      // the live edge is the newest available segment, join it delayed by LiveEdgeDelay
+      int64_t now = Simulator::Now ().GetMicroSeconds ();
+      int64_t segmentDuration = m_videoData->segmentDuration;
+      if (now >= (int64_t) m_liveStart)
+        {
+          int64_t liveEdge = (now - (int64_t) m_liveStart) / segmentDuration;
+          int64_t delay = ((int64_t) m_liveEdgeDelay + segmentDuration - 1) / segmentDuration;
+          m_joinIndex = std::min (std::max (liveEdge - delay, (int64_t) 0), segmentCount - 1);
+        }
+    }
+  m_lastSegmentIndex = segmentCount - m_joinIndex;
+}
+
+} // Namespace ns3
@@ -21,19 +21,31 @@
 
 #include "ns3/application.h"
 #include "ns3/event-id.h"
+#include "ns3/nstime.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/traced-callback.h"
+#include "ns3/traced-value.h"
+#include <deque>
+#include <set>
 #include <iostream>
 #include <fstream>
 #include "tcp-stream-adaptation-algorithm.h"
 #include "tcp-stream-interface.h"
+#include "tcp-stream-qoe.h"
 #include "tobasco2.h"
 #include "festive.h"
 #include "panda.h"
 #include "simple.h"
 #include "mpc.h"
 #include "bola.h"
+#include "cross-layer.h"
+#include "bba.h"
+#include "neural.h"
+#include "low-latency.h"
+#include "elastic.h"
+#include "tile.h"
+#include "tcp-stream-viewport.h"
 
 
 namespace ns3 {
@@ -88,6 +100,92 @@ public:
    */
   void SetRemote (Address ip, uint16_t port);
 
+  /**
+   * \return the current buffer level in microseconds, taking the playback since the last download into account
+   */
+  int64_t GetBufferLevel () const;
+  /**
+   * \return the representation index of the segment that is currently played, 0 before playback started
+   */
+  int64_t GetPlaybackRepIndex () const;
+  /**
+   * \return the live latency in microseconds at the start of the playback of the current segment
+   */
+  int64_t GetLiveLatency () const;
+  /**
+   * \return the number of bytes received from the server since the client started
+   */
+  uint64_t GetTotalBytesReceived () const;
+  /**
+   * \return the number of enhancement layer bytes that arrived after the playback of their segment had started, 0 unless ScalableVideo is set
+   */
+  uint64_t GetWastedBytes () const;
+  /**
+   * \return the number of requests sent to the server, one per tile of a tiled video
+   */
+  uint64_t GetRequestsSent () const;
+  /**
+   * \return true if the client is connected to the server, i.e. the streaming session started and has not ended yet
+   */
+  bool IsStreaming () const;
+
+  /**
+   * TracedCallback signature for a completely downloaded segment.
+   *
+   * \param [in] segmentIndex index of the segment
+   * \param [in] repIndex representation index of the segment
+   * \param [in] bytes size of the segment in bytes
+   * \param [in] requestSent point in time in microseconds when the request was sent
+   * \param [in] downloadStart point in time in microseconds when the first packet arrived
+   * \param [in] downloadEnd point in time in microseconds when the last packet arrived
+   */
+  typedef void (* SegmentDownloadedCallback)(int64_t segmentIndex, int64_t repIndex, int64_t bytes,
+                                             int64_t requestSent, int64_t downloadStart, int64_t downloadEnd);
+  /**
+   * TracedCallback signature for a change of the requested representation.
+   *
+   * \param [in] segmentIndex index of the segment requested with the new representation
+   * \param [in] oldRepIndex representation index of the previous segment
+   * \param [in] newRepIndex representation index of this segment
+   */
+  typedef void (* RepresentationSwitchedCallback)(int64_t segmentIndex, int64_t oldRepIndex, int64_t newRepIndex);
+  /**
+   * TracedCallback signature for a new buffer level.
+   *
+   * \param [in] bufferLevel buffer level in microseconds
+   * \param [in] segmentsInBuffer number of segments in the buffer
+   */
+  typedef void (* BufferLevelCallback)(int64_t bufferLevel, int64_t segmentsInBuffer);
+  /**
+   * TracedCallback signature for the start of a buffer underrun.
+   *
+   * \param [in] segmentIndex index of the segment the playback is waiting for
+   */
+  typedef void (* StallStartedCallback)(int64_t segmentIndex);
+  /**
+   * TracedCallback signature for the end of a buffer underrun.
+   *
+   * \param [in] segmentIndex index of the segment whose playback starts
+   * \param [in] duration duration of the buffer underrun in microseconds
+   */
+  typedef void (* StallEndedCallback)(int64_t segmentIndex, int64_t duration);
+  /**
+   * TracedCallback signature for the start of the playback of a segment.
+   *
+   * \param [in] segmentIndex index of the segment
+   * \param [in] repIndex representation index of the segment
+   * \param [in] liveLatency live latency in microseconds
+   * \param [in] playbackTime point in time in microseconds at which the playback started, which may
+   *              lie before the time the trace is fired (see AdvancePlayback)
+   */
+  typedef void (* PlaybackStartedCallback)(int64_t segmentIndex, int64_t repIndex, int64_t liveLatency, int64_t playbackTime);
+  /**
+   * TracedCallback signature for the end of a streaming session.
+   *
+   * \param [in] clientId the id of the client whose session ended
+   */
+  typedef void (* SessionEndedCallback)(uint16_t clientId);
+
 protected:
   virtual void DoDispose (void);
 
@@ -109,6 +207,9 @@ private:
     downloadFinished, playbackFinished, irdFinished, init, delayedSend
   };
   AdaptationAlgorithm *algo;
+  std::string m_shadowAlgorithms; //!< Comma separated names of the shadow algorithms
+  std::vector<std::pair<std::string, AdaptationAlgorithm *> > m_shadowAlgos; //!< The shadow algorithms with their names
+  std::vector<int64_t> m_shadowDisagreements; //!< Number of decisions of every shadow algorithm that differ from the primary algorithm
 
   virtual void StartApplication (void);
   virtual void StopApplication (void);
@@ -122,7 +223,7 @@ private:
    * - The log files are being initialised.
    *
    * After these initialisations, which take place at object creation, a TCP connection to the server is initiated and the callbacks for a succeeded connection and for receiving are set. Then, the controller does the transition initial init-> downloading by calling RequestRepIndex (), thus obtaining the next representation level to be downloaded. The client then requests the determined segment size from the server by sending it a string composed of the number of bytes of the segment. After the request is processed by the server, it starts sending the first TCP packet to the client. The receiving of a packet notifies the socket that new data is available to be read, so the aforementioned SetRcvCallback is triggered and the client stars receiving packets. Meanwhile all arrived packets are being logged. This is repeated until the received amount of data matches the requested segment size. Then, the throughput is logged and the receive function calls the controller with the event  downloadFinished.
-   * The controller then adds a segment to the buffer and calls the PlaybackHandle() function. Here, the segment buffer is decremented by one segment, thus simulating the beginning of playback. Then, the function returns to the controller, where a timer of m_segmentDuration microseconds is set to call PlaybackHandle() again, after playback of the prior segment is finished. Next, the requests the next segment as described before. Therefore, the controller does the transition downloading downloadfinished-> downloadingPlaying.
+   * The controller then adds a segment to the buffer and calls the PlaybackHandle() function. Here, the segment buffer is decremented by one segment, thus simulating the beginning of playback. Then, the function returns to the controller, where the playback clock is started, which calls PlaybackHandle() again every m_segmentDuration microseconds, after playback of the prior segment is finished. The playback clock is analytic (see AdvancePlayback()): the playback instants are handled lazily before the next controller event, and an event is only scheduled for the point in time when the buffer can run dry. Next, the requests the next segment as described before. Therefore, the controller does the transition downloading downloadfinished-> downloadingPlaying.
 
    * Now being in state downloadingPlaying, the next possible transitions are
    * - downloadingPlaying downloadFinished-> downloadingPlaying: download of a segment is finished. The download of the next segment is started.
@@ -149,12 +250,18 @@ private:
    */
   template <typename T>
   void Send (T & message);
+  /**
+   * \brief Request the segment m_segmentCounter in representation m_currentRepIndex from the server.
+   */
+  void SendRequest ();
   /**
    * \brief Handle a packet reception.
    *
    * This function is called by lower layers, triggered by SetRecvCallback.
    * It increments m_bytesReceived by the number of bytes received and calls SegmentReceivedHandle()
-   * when m_bytesReceived == size of segment that is expected to be received.
+   * when m_bytesReceived == size of segment that is expected to be received, or UpgradeReceivedHandle()
+   * when an enhancement layer is complete. With a tiled video, TileReceivedHandle() is called for
+   * every tile on the way. Bytes of outstanding audio segments, which arrive first, are handed to ReceiveAudio().
    *
    * \param socket the socket the packet was received to.
    */
@@ -172,25 +279,132 @@ private:
    * of bytes == the requested number of bytes. Throughput data and buffer data is logged.
    */
   void SegmentReceivedHandle ();
+  /**
+   * \brief Request the next enhancement layer of a buffered segment, if ScalableVideo is set.
+   *
+   * Only while the client waits for its next segment request, i.e. in the playing state. Of the buffered
+   * segments below m_currentRepIndex, the one with the fewest layers is upgraded, the earliest one on a tie,
+   * if the layer can be downloaded at the throughput of the last segment at least UpgradeMargin before
+   * the playback of the segment starts.
+   */
+  void StartUpgrade ();
+  /**
+   * Called after an enhancement layer was completely received. The layer is added to its segment if
+   * the segment has not been played yet, then either the deferred segment request is sent or the next
+   * layer is requested.
+   */
+  void UpgradeReceivedHandle ();
+  /**
+   * \brief Request the next tile of the segment m_segmentCounter of a tiled video.
+   */
+  void SendTileRequest ();
+  /**
+   * Called when the bytes of the next tile of a tiled video were received. The tile is logged and, if
+   * tiles of the segment are left, the next one is requested, so that TilePipelineDepth requests are
+   * outstanding.
+   */
+  void TileReceivedHandle ();
+  /**
+   * \brief Request the audio segments that are due before the video segment m_segmentCounter.
+   *
+   * Audio segments are requested up to AudioLead segments ahead of m_segmentCounter, as far as they
+   * are available yet. With AudioPipelining all of them are requested at once and the video segment
+   * right after them, otherwise one at a time and the video segment when the last one arrived. Audio
+   * segments requested ahead for a content index that the video track skipped (see MapSegment) are
+   * requested again for the new content index.
+   *
+   * \return true if the video segment has to wait for audio segments
+   */
+  bool RequestAudio ();
+  /**
+   * \brief Account for received bytes of the outstanding audio segments, which arrive before the video segment.
+   *
+   * \param bytes the number of received bytes
+   * \return the number of these bytes that belong to audio segments
+   */
+  uint32_t ReceiveAudio (uint32_t bytes);
+  /**
+   * Called after an audio segment was completely received. The audio segment is added to the audio
+   * buffer and the deferred video request is sent, if it was waiting for this segment.
+   */
+  void AudioReceivedHandle ();
   /**
    * \brief Read in bitrate values
    *
    * The test bitrate values to be read must be provided in bytes in absolute sizes (not per second!)
    * as a 2x2 matrix, with spaces separating the segment sizes and newlines for every representation level.
+   * The file is read only once per process and segment duration, see TcpStreamCatalog. With TiledVideo
+   * the file is a tile grid file, see TcpStreamCatalog::GetTiledVideo.
    */
   int ReadInBitrateValues (std::string segmentSizeFile);
   /*
    * \brief Controls / simulates playback process
    *
-   * Gets called by a timer, when the simulated playback of a segment is finished.
+   * Gets called for every point in time when the simulated playback of a segment is finished.
    * If m_segmentsInBuffer > 0, then m_segmentsInBuffer is decremented and m_currentPlaybackIndex
    * is incremented. Also, if there was a buffer underrun before, m_bufferUnderrun is set to false
    * and the end of a buffer underrun is logged. If m_segmentsInBuffer == 0, a buffer underrun is
    * registered by writing the event in the bufferUnderrun logfile and m_bufferUnderrun is set to true.
    *
+   * \param timeNow the point in time in microseconds of this playback instant, which can lie in the past (see AdvancePlayback ())
    * \return true if there is a buffer underrun
    */
-  bool PlaybackHandle ();
+  bool PlaybackHandle (int64_t timeNow);
+  /*
+   * \brief Analytic playback clock
+   *
+   * While playback is running, a segment is taken out of the buffer every m_segmentDuration
+   * microseconds, starting at m_nextPlaybackTime. Instead of scheduling an event for every segment,
+   * all playback instants up to timeNow are handled here in one go, in the same order and with the
+   * same timestamps as the former per-segment playbackFinished events. It is called before every
+   * controller event and every completed download, so that these always see the current playback state.
+   */
+  void AdvancePlayback (Time timeNow);
+  /*
+   * \brief Schedule a playbackFinished event for the next point in time when the buffer can run dry.
+   *
+   * That is the playback instant after all currently buffered segments are played, where either a
+   * buffer underrun or the end of playback happens. As downloads only move this point in time
+   * further away, an already scheduled earlier event is kept, it just calls this function again.
+   */
+  void SchedulePlaybackEvent ();
+  /*
+   * \return the number of playback instants up to timeNow that AdvancePlayback () has not handled yet
+   */
+  int64_t GetPendingPlaybacks (Time timeNow) const;
+  /*
+   * \brief Live latency control
+   *
+   * Chooses the playback rate of the segment whose playback starts, if TargetLatency is set. The rate
+   * rises by LatencyGain per second of live latency above the target (and falls below it), but as
+   * long as the buffer behind this segment is below SafeBuffer, it is at most 1 - BufferGain per
+   * second missing. If the adaptation algorithm asked for a playback rate with its last decision, that
+   * rate is used instead. The result is bounded by MinPlaybackRate and MaxPlaybackRate.
+   *
+   * \param liveLatency the live latency in microseconds at the start of the playback of the segment
+   */
+  void UpdatePlaybackRate (int64_t liveLatency);
+  /*
+   * \return the time it takes to play a segment at the current playback rate
+   */
+  Time GetPlaybackDuration () const;
+  /*
+   * \return the buffer level in microseconds required to start playback, or to resume it after a buffer underrun, at most the rest of the video
+   */
+  int64_t GetPlaybackThreshold () const;
+  /*
+   * \return true if there is a buffer underrun and the buffer has not reached the resume threshold yet
+   */
+  bool IsWaitingForResume () const;
+  /*
+   * \return the number of buffered segments that can be played, i.e. whose video and, with a separate
+   * audio track, audio segment are both buffered
+   */
+  int64_t GetPlayableSegments () const;
+  /*
+   * \brief Schedule an irdFinished or delayedSend event, remembering when it was scheduled for AdvancePlayback ().
+   */
+  void ScheduleRequest (Time delay, controllerEvent event);
   /*
    * \brief Request the next representation index from algorithm.
    *
@@ -229,13 +443,43 @@ private:
    * - size of packet
    */
   void LogThroughput (uint32_t packetSize);
+  /*
+   * \brief Count a received packet in the current throughput bin, closing the bins that ended before.
+   *
+   * Bins without packets are recorded with 0 bytes, at most ThroughputBins of them per gap.
+   *
+   * \param timeNow the arrival time of the packet in microseconds
+   * \param packetSize the size of the packet in bytes
+   */
+  void SampleThroughput (int64_t timeNow, uint32_t packetSize);
+  /*
+   * \brief Write the current throughput bin into the ring buffer of m_throughput and start the next one.
+   *
+   * \param binEnd the point in time in microseconds when the bin ends
+   */
+  void CloseThroughputBin (int64_t binEnd);
   /*
    * \brief Log information about playback process
    *
    * - index of segment of which playback will start next
    * - point in time when playback of above mentioned segment starts
+   *
+   * \param playbackTime the point in time in microseconds when the playback of the segment starts
+   */
+  void LogPlayback (int64_t playbackTime);
+  /**
+   * \brief Log the enhancement layer that was just received.
+   * \param used true if the layer arrived before the playback of its segment started
+   */
+  void LogUpgrade (bool used);
+  /**
+   * \brief Log the tile that was just received.
    */
-  void LogPlayback ();
+  void LogTile ();
+  /**
+   * \brief Log the audio segment that was just received.
+   */
+  void LogAudio ();
   /*
    * \brief Log information about adaptation algorithm.
    *
@@ -257,7 +501,58 @@ private:
   /*
   	Returns the availability time for a segment/chunk (when it will become available for download). 
   */
-  double getAvailabilityTime(int64_t segmentIndex);
+  double getAvailabilityTime(int64_t segmentIndex) const;
+  /*
+   * \brief Map a request index to the index of the segment in the video file.
+   *
+   * Segments that are not requested yet are assumed to follow the last requested one.
+   */
+  int64_t GetContentIndex (int64_t segmentIndex) const;
+  /*
+   * \return the size in bytes of the segment with request index segmentIndex in representation repIndex
+   */
+  int64_t GetSegmentSize (int64_t repIndex, int64_t segmentIndex) const;
+  /*
+   * \brief Fix the index in the video file of the segment that is requested next.
+   *
+   * If the segment already left the DVR window, the oldest segment still available is requested instead.
+   */
+  void MapSegment ();
+  /*
+   * \brief Choose the first segment of the session, at the start or at the live edge of the stream.
+   */
+  void JoinLiveStream ();
+  /*
+   * \brief Hand the final QoE metrics of this client to the TcpStreamQoeAggregator.
+   *
+   * Called when the streaming session ends or the client is disposed, only the first call has an effect.
+   */
+  void ReportQoe ();
+  /**
+   * \brief Create an adaptation algorithm working on the data of this client.
+   *
+   * \param algorithm the name of the algorithm
+   * \return the algorithm, NULL if the name is unknown
+   */
+  AdaptationAlgorithm * CreateAlgorithm (std::string algorithm);
+  /**
+   * \brief Ask every shadow algorithm for its decision on the segment the primary algorithm just decided on.
+   *
+   * The decisions are counted and logged only, they don't affect the requests. As all algorithms read
+   * the client's history, the shadows see the consequences of the primary algorithm's decisions, not
+   * of their own, i.e. the comparison is a first-order one.
+   *
+   * \param answer the decision of the primary algorithm
+   */
+  void EvaluateShadows (const algorithmReply &answer);
+  /**
+   * \brief Delete all shadow algorithms.
+   */
+  void DeleteShadows ();
+  /**
+   * \brief Stop the updates of m_transport, called when the connection is closed or the client is disposed.
+   */
+  void UnregisterTransport ();
 
   uint32_t m_dataSize; //!< packet payload size
   uint8_t *m_data; //!< packet payload data
@@ -267,15 +562,19 @@ private:
   uint16_t m_peerPort; //!< Remote peer port
 
   uint16_t m_clientId; //!< The Id of this client, for logging purposes
-  uint16_t m_simulationId; //!< The Id of this simulation, for logging purposes
+  uint32_t m_simulationId; //!< The Id of this simulation, for logging purposes
   uint16_t m_numberOfClients; //!< The total number of clients for this simulation, for logging purposes
   std::string m_segmentSizeFilePath; //!< The relative path (from ns-3.x directory) to the file containing the segment sizes in bytes
+  std::string m_catalogFile; //!< The file listing the segment size files of all titles, empty to play m_segmentSizeFilePath
+  int64_t m_requestedVideoId; //!< The title to play, -1 to draw it from the Zipf distribution
+  double m_zipfExponent; //!< The exponent of the Zipf popularity distribution
+  int64_t m_videoId; //!< The played title, sent with every request
   std::string m_algoName;//!< Name of the apation algorithm's class which this client will use for the simulation
   bool m_bufferUnderrun; //!< True if there is currently a buffer underrun in the simulated playback
   int64_t m_currentPlaybackIndex; //!< The index of the segment that is currently being played
   int64_t m_segmentsInBuffer; //!< The number of segments that are currently in the buffer
   int64_t m_currentRepIndex; //!< The index of the currently requested segment quality
-  int64_t m_lastSegmentIndex;//!< The index of the last segment, i.e. the total number of segments-1
+  int64_t m_lastSegmentIndex;//!< The index of the last segment, i.e. the total number of segments-1, counted from the first segment of the session
   int64_t m_segmentCounter; //!< The index of the next segment to be downloaded
   int64_t m_transmissionStartReceivingSegment; //!< The point in time in microseconds when the transmission of a segment begins
   int64_t m_transmissionEndReceivingSegment; //!< The point in time in microseconds when the transmission of a segment is finished
@@ -283,6 +582,66 @@ private:
   int64_t m_bDelay;  //!< Minimum buffer level in microseconds of playback when the next download must be started
   int64_t m_highestRepIndex; //!< This is the index of the highest representation
   uint64_t m_segmentDuration; //!< The duration of a segment in microseconds
+  uint64_t m_startupBuffer; //!< The buffer level in microseconds required to start playback
+  uint32_t m_startupSegments; //!< The number of buffered segments required to start playback
+  uint64_t m_resumeBuffer; //!< The buffer level in microseconds required to resume playback after a buffer underrun
+  uint32_t m_resumeSegments; //!< The number of buffered segments required to resume playback after a buffer underrun
+  uint64_t m_maxBuffer; //!< The maximum buffer level in microseconds, 0 for no limit
+  uint64_t m_binDuration; //!< The duration of a throughput bin in microseconds, 0 to disable intra-segment sampling
+  uint32_t m_binCapacity; //!< The number of throughput bins kept in m_throughput
+  int64_t m_binStart; //!< The point in time in microseconds when the current throughput bin started
+  int64_t m_binBytes; //!< The number of bytes received in the current throughput bin
+  uint64_t m_liveStart; //!< The point in time in microseconds when the first segment becomes available
+  bool m_joinAtLiveEdge; //!< True if the client starts at the live edge instead of the first segment
+  uint64_t m_liveEdgeDelay; //!< How far in microseconds behind the live edge the client joins
+  uint64_t m_dvrWindow; //!< How long in microseconds a segment stays available, 0 for no limit
+  int64_t m_joinIndex; //!< The index in the video file of the first segment of the session
+  uint64_t m_targetLatency; //!< The live latency in microseconds the playback rate is controlled to, 0 for no control
+  double m_minPlaybackRate; //!< The lowest playback rate of the live latency control
+  double m_maxPlaybackRate; //!< The highest playback rate of the live latency control
+  double m_latencyGain; //!< Change of the playback rate per second of live latency error
+  uint64_t m_safeBuffer; //!< Buffer level in microseconds below which the playback is not sped up
+  double m_bufferGain; //!< Decrease of the playback rate per second of buffer level below m_safeBuffer
+  TracedValue<double> m_playbackRate; //!< The playback rate of the segment that is currently played
+  double m_requestedPlaybackRate; //!< The playback rate the adaptation algorithm asked for, 0 if it leaves it to the client
+  bool m_scalableVideo; //!< True if the representations are the cumulated layers of a scalable video and buffered segments are upgraded
+  uint64_t m_upgradeMargin; //!< How long in microseconds an enhancement layer must be expected to arrive before the playback of its segment
+  std::vector<int64_t> m_bufferedRepIndex; //!< The representation of every requested segment as it is played, raised by enhancement layer upgrades
+  int64_t m_expectedBytes; //!< The size in bytes of the segment or layer currently being downloaded
+  bool m_tiledVideo; //!< True if the segment size file is a tile grid file (see TcpStreamCatalog::GetTiledVideo)
+  uint32_t m_pipelineDepth; //!< The number of tile requests that are outstanding at a time, 0 to request all tiles of a segment at once
+  std::string m_viewportTraceFile; //!< The viewport trace of the viewer, empty for a synthetic trace
+  double m_viewportSpeed; //!< The angular speed in degrees per second of the synthetic viewer
+  uint64_t m_viewportDwell; //!< The mean time in microseconds the synthetic viewer looks at one direction
+  double m_fovYaw; //!< The horizontal field of view in degrees
+  double m_fovPitch; //!< The vertical field of view in degrees
+  TcpStreamViewport m_viewport; //!< The head movement of the viewer
+  std::vector<int64_t> m_tileRepIndex; //!< The representation of every tile of the segment m_segmentCounter
+  std::vector<int64_t> m_tileEnd; //!< The number of bytes of the segment m_segmentCounter up to the end of every tile, in request order
+  std::vector<int64_t> m_tileRequestSent; //!< The point in time in microseconds when every tile of the segment m_segmentCounter was requested
+  std::vector<double> m_viewportWeights; //!< The share of every tile in the viewport in the middle of the segment m_segmentCounter
+  int64_t m_tilesRequested; //!< The number of tiles of the segment m_segmentCounter requested so far
+  int64_t m_tilesReceived; //!< The number of tiles of the segment m_segmentCounter received so far
+  uint64_t m_requestsSent; //!< The number of requests sent to the server
+  std::string m_audioSegmentSizeFile; //!< The segment size file of the separate audio track, empty if audio and video are muxed
+  uint32_t m_audioRepIndex; //!< The representation of the audio track
+  uint32_t m_audioLead; //!< How many segments the audio track is requested ahead of the video track
+  bool m_audioPipelining; //!< True if the audio requests and the next video request are sent back to back
+  const videoData *m_audioData; //!< The audio track, shared by all clients playing it, 0 if audio and video are muxed
+  int64_t m_audioRequested; //!< The segment index of the next audio segment to request
+  std::vector<int64_t> m_audioContentIndex; //!< The content index each audio segment was requested for, by segment index
+  std::set<int64_t> m_audioBuffered; //!< The content indices of the received audio segments that were not played yet
+  std::deque<int64_t> m_audioRequests; //!< The sizes in bytes of the outstanding audio requests, in request order
+  std::deque<int64_t> m_audioRequestContent; //!< The content indices of the outstanding audio requests, in request order
+  std::deque<int64_t> m_audioRequestSent; //!< The points in time in microseconds when the outstanding audio segments were requested
+  int64_t m_audioBytesReceived; //!< The number of bytes received of the first outstanding audio segment
+  int64_t m_audioDownloadStart; //!< The point in time in microseconds when the first byte of the first outstanding audio segment arrived
+  bool m_videoRequestDeferred; //!< True if the request of the video segment m_segmentCounter waits for audio segments
+  bool m_upgradeInProgress; //!< True while an enhancement layer is being downloaded
+  int64_t m_upgradeSegment; //!< The index of the segment the enhancement layer being downloaded belongs to
+  int64_t m_upgradeLayer; //!< The representation the segment reaches with the enhancement layer being downloaded
+  bool m_requestAfterUpgrade; //!< True if a segment request became due during an upgrade and is sent after it
+  uint64_t m_wastedBytes; //!< The number of enhancement layer bytes that arrived too late to be played
 
   std::ofstream adaptationLog; //!< Output stream for logging adaptation information
   std::ofstream downloadLog; //!< Output stream for logging download information
@@ -290,16 +649,50 @@ private:
   std::ofstream bufferLog; //!< Output stream for logging buffer course
   std::ofstream throughputLog; //!< Output stream for logging throughput information
   std::ofstream bufferUnderrunLog; //!< Output stream for logging starting and ending of buffer underruns
+  std::ofstream shadowLog; //!< Output stream for logging the decisions of the shadow algorithms
+  std::ofstream throughputBinLog; //!< Output stream for logging the throughput bins
+  std::ofstream layerLog; //!< Output stream for logging the enhancement layer upgrades
+  std::ofstream tileLog; //!< Output stream for logging the tile downloads
+  std::ofstream audioLog; //!< Output stream for logging the audio downloads
 
   uint64_t m_downloadRequestSent; //!< Logging the point in time in microseconds when a download request was sent to the server
 
   throughputData m_throughput; //!< Tracking the throughput
   bufferData m_bufferData; //!< Keep track of the buffer level
   playbackData m_playbackData; //!< Tracking the simulated playback of segments
-  videoData m_videoData; //!< Information about segment sizes, average bitrates of representation levels and segment duration in microseconds
+  transportData m_transport; //!< TCP state of the connection, updated from the server's socket
+  Address m_transportAddress; //!< The address m_transport is registered under at the TcpStreamTransportRegistry, the local address of m_socket
+  bool m_transportRegistered; //!< True if m_transport is registered at the TcpStreamTransportRegistry
+  const videoData *m_videoData; //!< Information about segment sizes, average bitrates of representation levels and segment duration in microseconds, shared by all clients playing the same video (see TcpStreamCatalog)
 
   bool playbackStarted;
 
+  bool m_profiling; //!< True if the client callbacks are counted by TcpStreamProfiler
+  bool m_algorithmProfiling; //!< True if the calls of the adaptation algorithm are counted by TcpStreamProfiler
+
+  TcpStreamQoe m_qoe; //!< QoE metrics of this streaming session
+  bool m_qoeSummary; //!< True if the QoE metrics of this client are added to the fleet QoE summary
+  bool m_sessionEnded; //!< True once StopApplication () ran
+  bool m_qoeRegistered; //!< True if this client is registered at the TcpStreamQoeAggregator and has not reported yet
+
+  bool m_fileLogging; //!< True if the log files of this client are written
+  int64_t m_underrunStart; //!< The point in time in microseconds when the current buffer underrun started
+  int64_t m_liveLatency; //!< The live latency in microseconds at the start of the playback of the current segment
+  uint64_t m_totalBytesReceived; //!< The number of bytes received since the client started
+  bool m_playbackRunning; //!< True if the playback clock is running, i.e. a segment is played at m_nextPlaybackTime if there is one in the buffer
+  Time m_nextPlaybackTime; //!< The next point in time when the playback of a segment finishes
+  EventId m_playbackEvent; //!< The event at the next point in time when the buffer can run dry
+  EventId m_requestEvent; //!< The pending irdFinished or delayedSend event
+  Time m_requestScheduled; //!< The point in time when m_requestEvent was scheduled
+
+  TracedCallback<int64_t, int64_t, int64_t, int64_t, int64_t, int64_t> m_segmentDownloadedTrace; //!< A segment was completely downloaded
+  TracedCallback<int64_t, int64_t, int64_t> m_representationSwitchedTrace; //!< The requested representation changed
+  TracedCallback<int64_t, int64_t> m_bufferLevelTrace; //!< The buffer level changed by a downloaded segment
+  TracedCallback<int64_t> m_stallStartedTrace; //!< A buffer underrun started
+  TracedCallback<int64_t, int64_t> m_stallEndedTrace; //!< A buffer underrun ended
+  TracedCallback<int64_t, int64_t, int64_t, int64_t> m_playbackStartedTrace; //!< The playback of a segment started
+  TracedCallback<uint16_t> m_sessionEndedTrace; //!< The streaming session ended, the video was played or the application was stopped
+
 };
 
 } // namespace ns3
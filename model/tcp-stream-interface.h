@@ -34,12 +34,16 @@ std::string const dashLogDirectory = "dash-log-files/";
  */
 struct algorithmReply
 {
+  algorithmReply () : nextRepIndex (0), nextDownloadDelay (0), decisionTime (0), decisionCase (0), delayDecisionCase (0),
+    bandwidthEstimate (0), playbackRate (0) {}
   int64_t nextRepIndex; //!< representation level index of the next segement to be downloaded by the client
   int64_t nextDownloadDelay; //!< delay time in microseconds when the next segment shall be requested from the server
   int64_t decisionTime; //!< time in microsends when the adaptation algorithm decided which segment to download next, only for logging purposes
   int64_t decisionCase; //!< indicate in which part of the adaptation algorithm's code the decision was made, which representation level to request next, only for logging purposes
   int64_t delayDecisionCase; //!< indicate in which part of the adaptation algorithm's code the decision was made, how much time in microsends to wait until the segment shall be requested from server, only for logging purposes
   double bandwidthEstimate; //bandwidth estimated by the ABR
+  double playbackRate; //!< playback rate the algorithm asks for from the next segment on, 0 to leave it to the client's live latency control
+  std::vector<int64_t> tileRepIndex; //!< representation level index of every tile of the next segment of a tiled video, empty to request all tiles in nextRepIndex
 };
 
 
@@ -48,14 +52,50 @@ struct algorithmReply
  *  \brief This is a struct containing throughput data.
  *
  * Contains throughput data that the adaptation algorithm is provided by the client. These values are
- * needed to compute the next representation index based on previous throughput.
+ * needed to compute the next representation index based on previous throughput. If the client attribute
+ * ThroughputBinDuration is set, the bytes received during a download are also counted in bins of fixed
+ * duration, the latest ThroughputBins bins are kept in a ring buffer. Bins start with the first packet of
+ * a segment and end with its last one, the idle time between downloads is not binned.
  */
 struct throughputData
 {
+  throughputData () : binDuration (0), binsWritten (0) {}
   std::vector<int64_t> transmissionRequested;       //!< Simulation time in microseconds when a segment was requested by the client
   std::vector<int64_t> transmissionStart;       //!< Simulation time in microseconds when the first packet of a segment was received
   std::vector<int64_t> transmissionEnd;       //!< Simulation time in microseconds when the last packet of a segment was received
   std::vector<int64_t> bytesReceived;       //!< Number of bytes received, i.e. segment size
+  int64_t binDuration;       //!< Duration of a throughput bin in microseconds, 0 if intra-segment sampling is disabled
+  uint64_t binsWritten;       //!< Number of bins completed so far, the most recent one is at index (binsWritten - 1) % binStart.size () of the ring buffer below
+  std::vector<int64_t> binStart;       //!< Ring buffer: simulation time in microseconds when the bin started
+  std::vector<int64_t> binLength;       //!< Ring buffer: length of the bin in microseconds, shorter than binDuration for the last bin of a segment
+  std::vector<int64_t> binBytes;       //!< Ring buffer: number of bytes received during the bin
+  std::vector<int64_t> binSegment;       //!< Ring buffer: index of the segment downloaded during the bin
+};
+
+/*! \class transportData tcp-stream-interface.h "model/tcp-stream-interface.h"
+ *  \ingroup tcpStream
+ *  \brief This is a struct containing the state of the TCP connection of a client.
+ *
+ * Filled from the trace sources of the server's socket of the connection (see TcpStreamTransportRegistry),
+ * i.e. it reflects the sender side, so adaptation algorithms can react to capacity changes while a
+ * segment is still being downloaded. All values are 0 until the first trace event arrives. A delivery
+ * rate sample is the number of bytes acknowledged during about one smoothed round trip time; intervals
+ * where the connection was idle, i.e. between two segments, are not sampled.
+ */
+struct transportData
+{
+  transportData () : lastUpdate (0), congestionWindow (0), lastRtt (0), smoothedRtt (0), bytesInFlight (0),
+    sampleStart (0), sampleBytes (0), lastAckTime (0) {}
+  int64_t lastUpdate;       //!< Simulation time in microseconds of the last change of any of the values
+  uint32_t congestionWindow;       //!< congestion window of the sender in bytes
+  int64_t lastRtt;       //!< last round trip time sample in microseconds
+  int64_t smoothedRtt;       //!< smoothed round trip time in microseconds, as in RFC 6298
+  uint32_t bytesInFlight;       //!< bytes sent but not acknowledged yet
+  std::vector<int64_t> deliveryRateTime;       //!< Simulation time in microseconds at the end of every delivery rate sample, only the most recent samples are kept
+  std::vector<double> deliveryRate;       //!< delivery rate samples in bits per second
+  int64_t sampleStart;       //!< Simulation time in microseconds when the current delivery rate sample started
+  uint64_t sampleBytes;       //!< bytes acknowledged since sampleStart
+  int64_t lastAckTime;       //!< Simulation time in microseconds when the last new data was acknowledged
 };
 
 /*! \class bufferData tcp-stream-interface.h "model/tcp-stream-interface.h"
@@ -77,13 +117,19 @@ struct bufferData
  *
  * Reduced version of a MPEG-DASH Media Presentation Description (MPD), containing a 2D [i][j] matrix
  * containing the size of every segment j in representation level i, the average bitrate of every
- * representation level and the duration of a segment in microseconds.
+ * representation level and the duration of a segment in microseconds. A tiled video is a grid of
+ * tileRows x tileColumns tiles (row-major, row 0 at the top of the equirectangular frame), each with
+ * its own [i][j] matrix in tileSize; segmentSize and averageBitrate are then the sums over all tiles.
  */
 struct videoData
 {
+  videoData () : segmentDuration (0), tileRows (0), tileColumns (0) {}
   std::vector < std::vector<int64_t > > segmentSize;       //!< vector holding representation levels in the first dimension and their particular segment sizes in bytes in the second dimension
   std::vector < double > averageBitrate;       //!< holding the average bitrate of a segment in representation i in bits
   int64_t segmentDuration;       //!< duration of a segment in microseconds
+  int64_t tileRows;       //!< number of tile rows, 0 if the video isn't tiled
+  int64_t tileColumns;       //!< number of tile columns, 0 if the video isn't tiled
+  std::vector < std::vector < std::vector<int64_t > > > tileSize;       //!< segment sizes in bytes per tile, representation level and segment, empty if the video isn't tiled
 };
 
 /*! \class playbackData tcp-stream-interface.h "model/tcp-stream-interface.h"
@@ -99,6 +145,10 @@ struct playbackData
 {
   std::vector <int64_t> playbackIndex;       //!< Index of the video segment
   std::vector <int64_t> playbackStart; //!< Point in time in microseconds when playback of this segment started
+  std::vector <int64_t> liveLatency; //!< Live latency in microseconds at the start of the playback of every played segment
+  std::vector <double> playbackRate; //!< Playback rate of every played segment
+  std::vector <int64_t> contentIndex; //!< Index in the video file of every requested segment, differs from the request index if the client joined a live stream late or skipped expired segments
+  std::vector <double> tileWeights; //!< Predicted share of every tile that lies in the viewport during the segment being requested, empty if the video isn't tiled
 };
 
 } // namespace ns3
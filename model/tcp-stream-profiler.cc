@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-profiler.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include <fstream>
+#include <iomanip>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamProfiler");
+
+static GlobalValue g_profilerOutput ("DashProfilerOutput",
+                                     "The file the tcp stream profiling counters are written to when the simulator is destroyed, empty for no output",
+                                     StringValue (""),
+                                     MakeStringChecker ());
+
+static GlobalValue g_profilerFormat ("DashProfilerFormat",
+                                     "The format of DashProfilerOutput, table or json",
+                                     StringValue ("table"),
+                                     MakeStringChecker ());
+
+static const char * const g_probeNames[TcpStreamProfiler::PROBE_COUNT] = {
+  "TcpStreamClient::HandleRead",
+  "TcpStreamClient::Controller",
+  "TcpStreamServer::HandleRead",
+  "TcpStreamServer::HandleSend",
+  "AdaptationAlgorithm::GetNextRep",
+  "AdaptationAlgorithm::GetNextRep (shadow)"
+};
+
+static const char * const g_componentNames[TcpStreamProfiler::COMPONENT_COUNT] = {
+  "client",
+  "server",
+  "algorithm",
+  "shadow"
+};
+
+TcpStreamProfiler::counter TcpStreamProfiler::m_components[TcpStreamProfiler::COMPONENT_COUNT] = {};
+uint32_t TcpStreamProfiler::m_depth[TcpStreamProfiler::COMPONENT_COUNT] = {};
+TcpStreamProfiler::counter TcpStreamProfiler::m_probes[TcpStreamProfiler::PROBE_COUNT] = {};
+TcpStreamProfiler::counter TcpStreamProfiler::m_segments = {};
+bool TcpStreamProfiler::m_dumpScheduled = false;
+
+TcpStreamProfiler::counter &
+TcpStreamProfiler::GetComponent (Component component)
+{
+  return m_components[component];
+}
+
+TcpStreamProfiler::counter &
+TcpStreamProfiler::GetProbe (Probe probe)
+{
+  return m_probes[probe];
+}
+
+const char *
+TcpStreamProfiler::GetProbeName (Probe probe)
+{
+  return g_probeNames[probe];
+}
+
+TcpStreamProfiler::Component
+TcpStreamProfiler::GetComponentOf (Probe probe)
+{
+  switch (probe)
+    {
+    case CLIENT_HANDLE_READ:
+    case CLIENT_CONTROLLER:
+      return CLIENT;
+    case SERVER_HANDLE_READ:
+    case SERVER_HANDLE_SEND:
+      return SERVER;
+    case SHADOW_GET_NEXT_REP:
+      return SHADOW;
+    default:
+      return ALGORITHM;
+    }
+}
+
+void
+TcpStreamProfiler::AddSegment (uint64_t bytes)
+{
+  m_segments.calls++;
+  m_segments.bytes += bytes;
+}
+
+const TcpStreamProfiler::counter &
+TcpStreamProfiler::GetSegments ()
+{
+  return m_segments;
+}
+
+void
+TcpStreamProfiler::Reset ()
+{
+  for (int i = 0; i < COMPONENT_COUNT; i++)
+    {
+      m_components[i] = counter ();
+    }
+  for (int i = 0; i < PROBE_COUNT; i++)
+    {
+      m_probes[i] = counter ();
+    }
+  m_segments = counter ();
+}
+
+void
+TcpStreamProfiler::Print (std::ostream &os)
+{
+  os << std::left << std::setw (34) << "Probe"
+     << std::right << std::setw (14) << "Calls"
+     << std::setw (16) << "Wall_Time_s"
+     << std::setw (14) << "Mean_us"
+     << std::setw (16) << "Bytes" << "\n";
+  for (int i = 0; i < PROBE_COUNT; i++)
+    {
+      const counter &c = m_probes[i];
+      os << std::left << std::setw (34) << g_probeNames[i]
+         << std::right << std::setw (14) << c.calls
+         << std::setw (16) << std::fixed << std::setprecision (6) << c.wallTime / 1e9
+         << std::setw (14) << std::setprecision (3) << (c.calls > 0 ? c.wallTime / 1e3 / c.calls : 0.0)
+         << std::setw (16) << c.bytes << "\n";
+    }
+  for (int i = 0; i < COMPONENT_COUNT; i++)
+    {
+      const counter &c = m_components[i];
+      os << std::left << std::setw (34) << (std::string ("total ") + g_componentNames[i])
+         << std::right << std::setw (14) << c.calls
+         << std::setw (16) << std::fixed << std::setprecision (6) << c.wallTime / 1e9
+         << std::setw (14) << std::setprecision (3) << (c.calls > 0 ? c.wallTime / 1e3 / c.calls : 0.0)
+         << std::setw (16) << "-" << "\n";
+    }
+  os << std::left << std::setw (34) << "segments downloaded"
+     << std::right << std::setw (14) << m_segments.calls
+     << std::setw (16) << "-" << std::setw (14) << "-"
+     << std::setw (16) << m_segments.bytes << "\n";
+}
+
+void
+TcpStreamProfiler::PrintJson (std::ostream &os)
+{
+  os << "{\n  \"probes\": {\n";
+  for (int i = 0; i < PROBE_COUNT; i++)
+    {
+      const counter &c = m_probes[i];
+      os << "    \"" << g_probeNames[i] << "\": {\"calls\": " << c.calls
+         << ", \"wallTimeNs\": " << c.wallTime
+         << ", \"bytes\": " << c.bytes << "}" << (i + 1 < PROBE_COUNT ? "," : "") << "\n";
+    }
+  os << "  },\n  \"components\": {\n";
+  for (int i = 0; i < COMPONENT_COUNT; i++)
+    {
+      const counter &c = m_components[i];
+      os << "    \"" << g_componentNames[i] << "\": {\"calls\": " << c.calls
+         << ", \"wallTimeNs\": " << c.wallTime << "}" << (i + 1 < COMPONENT_COUNT ? "," : "") << "\n";
+    }
+  os << "  },\n  \"segments\": {\"count\": " << m_segments.calls << ", \"bytes\": " << m_segments.bytes << "}\n}\n";
+}
+
+void
+TcpStreamProfiler::ScheduleDump ()
+{
+  if (!m_dumpScheduled)
+    {
+      m_dumpScheduled = true;
+      Simulator::ScheduleDestroy (&TcpStreamProfiler::Dump);
+    }
+}
+
+void
+TcpStreamProfiler::Dump ()
+{
+  m_dumpScheduled = false;
+  StringValue output;
+  StringValue format;
+  g_profilerOutput.GetValue (output);
+  g_profilerFormat.GetValue (format);
+  if (output.Get ().empty ())
+    {
+      return;
+    }
+  std::ofstream file (output.Get ().c_str ());
+  if (!file)
+    {
+      NS_LOG_ERROR ("Could not open profiler output file " << output.Get ());
+      return;
+    }
+  if (format.Get () == "json")
+    {
+      PrintJson (file);
+    }
+  else
+    {
+      Print (file);
+    }
+}
+
+TcpStreamProfilerScope::TcpStreamProfilerScope (TcpStreamProfiler::Probe probe, bool enabled)
+  : m_probe (probe),
+    m_enabled (enabled),
+    m_outermost (false),
+    m_bytes (0)
+{
+  if (m_enabled)
+    {
+      m_outermost = TcpStreamProfiler::m_depth[TcpStreamProfiler::GetComponentOf (probe)]++ == 0;
+      m_start = std::chrono::steady_clock::now ();
+    }
+}
+
+TcpStreamProfilerScope::~TcpStreamProfilerScope ()
+{
+  if (!m_enabled)
+    {
+      return;
+    }
+  int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - m_start).count ();
+  TcpStreamProfiler::counter &p = TcpStreamProfiler::m_probes[m_probe];
+  p.calls++;
+  p.wallTime += elapsed;
+  p.bytes += m_bytes;
+  TcpStreamProfiler::Component component = TcpStreamProfiler::GetComponentOf (m_probe);
+  TcpStreamProfiler::m_depth[component]--;
+  if (m_outermost)
+    {
+      TcpStreamProfiler::counter &c = TcpStreamProfiler::m_components[component];
+      c.calls++;
+      c.wallTime += elapsed;
+      c.bytes += m_bytes;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_PROFILER_H
+#define TCP_STREAM_PROFILER_H
+
+#include <stdint.h>
+#include <chrono>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Per-process hot path counters of the tcp stream applications.
+ *
+ * Every instrumented callback (probe) keeps its number of invocations, its cumulative wall clock
+ * time and the number of bytes it handled. Additionally the wall clock time is accounted per
+ * component (client, server, algorithm), where only the outermost callback of a component is
+ * timed, so that nested calls (e.g. HandleRead -> Controller) are not counted twice.
+ *
+ * Instrumentation is switched on and off per component with the Profiling attributes of
+ * TcpStreamClient and TcpStreamServer. Compiling with DASH_DISABLE_PROFILING removes it completely.
+ * If the global value DashProfilerOutput is set, the counters are written to that file when the
+ * simulator is destroyed, as a table or as JSON (DashProfilerFormat).
+ */
+class TcpStreamProfiler
+{
+public:
+  /**
+   * \brief The components whose callbacks are timed.
+   */
+  enum Component
+  {
+    CLIENT, SERVER, ALGORITHM, SHADOW, COMPONENT_COUNT
+  };
+
+  /**
+   * \brief The instrumented callbacks.
+   */
+  enum Probe
+  {
+    CLIENT_HANDLE_READ, CLIENT_CONTROLLER, SERVER_HANDLE_READ, SERVER_HANDLE_SEND, ALGORITHM_GET_NEXT_REP, SHADOW_GET_NEXT_REP, PROBE_COUNT
+  };
+
+  /**
+   * \brief A single counter.
+   */
+  struct counter
+  {
+    uint64_t calls; //!< number of invocations
+    int64_t wallTime; //!< cumulative wall clock time in nanoseconds
+    uint64_t bytes; //!< number of bytes handled
+  };
+
+  /**
+   * \return the counter of the given component
+   */
+  static counter & GetComponent (Component component);
+  /**
+   * \return the counter of the given probe
+   */
+  static counter & GetProbe (Probe probe);
+  /**
+   * \return the name of the given probe, as used in the table and JSON output
+   */
+  static const char * GetProbeName (Probe probe);
+  /**
+   * \brief Count a completely downloaded segment of size bytes.
+   */
+  static void AddSegment (uint64_t bytes);
+  /**
+   * \return the counter holding the number and size of all downloaded segments
+   */
+  static const counter & GetSegments ();
+  /**
+   * \brief Set all counters to zero.
+   */
+  static void Reset ();
+  /**
+   * \brief Write all counters as a human readable table.
+   */
+  static void Print (std::ostream &os);
+  /**
+   * \brief Write all counters as a JSON object.
+   */
+  static void PrintJson (std::ostream &os);
+  /**
+   * \brief Write the counters to the file given by DashProfilerOutput when the simulator is destroyed.
+   *
+   * Can be called any number of times, the dump is only scheduled once per simulation.
+   */
+  static void ScheduleDump ();
+
+private:
+  friend class TcpStreamProfilerScope;
+  /**
+   * \brief Write the counters to DashProfilerOutput, called by Simulator::Destroy ().
+   */
+  static void Dump ();
+  static Component GetComponentOf (Probe probe);
+  static counter m_components[COMPONENT_COUNT]; //!< counters per component
+  static uint32_t m_depth[COMPONENT_COUNT]; //!< nesting depth of currently running callbacks per component
+  static counter m_probes[PROBE_COUNT]; //!< counters per probe
+  static counter m_segments; //!< downloaded segments
+  static bool m_dumpScheduled; //!< true if Dump () is already scheduled for the running simulation
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Times the enclosing block and adds it to the counters of a probe and its component.
+ *
+ * Does nothing if constructed with enabled == false. Use the DASH_PROFILE_SCOPE and
+ * DASH_PROFILE_BYTES macros instead of using this class directly, so that the instrumentation
+ * can be compiled out.
+ */
+class TcpStreamProfilerScope
+{
+public:
+  TcpStreamProfilerScope (TcpStreamProfiler::Probe probe, bool enabled);
+  ~TcpStreamProfilerScope ();
+  /**
+   * \brief Add bytes to the number of bytes handled by the probe.
+   */
+  void AddBytes (uint64_t bytes)
+  {
+    m_bytes += bytes;
+  }
+
+private:
+  TcpStreamProfiler::Probe m_probe; //!< the probe the time is accounted to
+  bool m_enabled; //!< false if this scope does not count anything
+  bool m_outermost; //!< true if this scope is not nested in another scope of the same component
+  uint64_t m_bytes; //!< bytes handled within this scope
+  std::chrono::steady_clock::time_point m_start; //!< wall clock time the scope was entered
+};
+
+} // namespace ns3
+
+#ifdef DASH_DISABLE_PROFILING
+#define DASH_PROFILE_SCOPE(name, probe, enabled)
+#define DASH_PROFILE_BYTES(name, bytes)
+#else
+#define DASH_PROFILE_SCOPE(name, probe, enabled) ns3::TcpStreamProfilerScope name (ns3::TcpStreamProfiler::probe, enabled)
+#define DASH_PROFILE_BYTES(name, bytes) name.AddBytes (bytes)
+#endif
+
+#endif /* TCP_STREAM_PROFILER_H */
@@ -0,0 +1,395 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-qoe.h"
+#include "tcp-stream-interface.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamQoe");
+
+static const double g_percentiles[] = { 0.5, 0.9, 0.95, 0.99 };
+static const size_t g_percentileCount = sizeof (g_percentiles) / sizeof (g_percentiles[0]);
+
+P2Quantile::P2Quantile (double quantile)
+  : m_quantile (quantile)
+{
+  Reset ();
+}
+
+void
+P2Quantile::Reset ()
+{
+  m_count = 0;
+  for (int i = 0; i < 5; i++)
+    {
+      m_height[i] = 0;
+      m_position[i] = i + 1;
+    }
+  m_desired[0] = 1;
+  m_desired[1] = 1 + 2 * m_quantile;
+  m_desired[2] = 1 + 4 * m_quantile;
+  m_desired[3] = 3 + 2 * m_quantile;
+  m_desired[4] = 5;
+  m_increment[0] = 0;
+  m_increment[1] = m_quantile / 2;
+  m_increment[2] = m_quantile;
+  m_increment[3] = (1 + m_quantile) / 2;
+  m_increment[4] = 1;
+}
+
+double
+P2Quantile::Parabolic (int i, double d) const
+{
+  return m_height[i] + d / (m_position[i + 1] - m_position[i - 1])
+         * ((m_position[i] - m_position[i - 1] + d) * (m_height[i + 1] - m_height[i]) / (m_position[i + 1] - m_position[i])
+            + (m_position[i + 1] - m_position[i] - d) * (m_height[i] - m_height[i - 1]) / (m_position[i] - m_position[i - 1]));
+}
+
+double
+P2Quantile::Linear (int i, int d) const
+{
+  return m_height[i] + d * (m_height[i + d] - m_height[i]) / (m_position[i + d] - m_position[i]);
+}
+
+void
+P2Quantile::Add (double x)
+{
+  if (m_count < 5)
+    {
+      m_height[m_count++] = x;
+      if (m_count == 5)
+        {
+          std::sort (m_height, m_height + 5);
+        }
+      return;
+    }
+  m_count++;
+
+  int k;
+  if (x < m_height[0])
+    {
+      m_height[0] = x;
+      k = 0;
+    }
+  else if (x >= m_height[4])
+    {
+      m_height[4] = x;
+      k = 3;
+    }
+  else
+    {
+      k = 0;
+      while (x >= m_height[k + 1])
+        {
+          k++;
+        }
+    }
+  for (int i = k + 1; i < 5; i++)
+    {
+      m_position[i]++;
+    }
+  for (int i = 0; i < 5; i++)
+    {
+      m_desired[i] += m_increment[i];
+    }
+
+  // adjust the heights of the three middle markers if they are off their desired positions
+  for (int i = 1; i < 4; i++)
+    {
+      double d = m_desired[i] - m_position[i];
+      if ((d >= 1 && m_position[i + 1] - m_position[i] > 1) || (d <= -1 && m_position[i - 1] - m_position[i] < -1))
+        {
+          int sign = d > 0 ? 1 : -1;
+          double height = Parabolic (i, sign);
+          if (m_height[i - 1] < height && height < m_height[i + 1])
+            {
+              m_height[i] = height;
+            }
+          else
+            {
+              m_height[i] = Linear (i, sign);
+            }
+          m_position[i] += sign;
+        }
+    }
+}
+
+double
+P2Quantile::Get () const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  if (m_count < 5)
+    {
+      double sorted[5];
+      std::copy (m_height, m_height + m_count, sorted);
+      std::sort (sorted, sorted + m_count);
+      size_t rank = (size_t) std::ceil (m_quantile * m_count);
+      return sorted[rank > 0 ? rank - 1 : 0];
+    }
+  return m_height[2];
+}
+
+TcpStreamQoe::TcpStreamQoe ()
+  : m_lastRepIndex (-1),
+    m_lastBitrate (0),
+    m_stallStart (-1)
+{
+  m_metrics = qoeMetrics ();
+  m_metrics.startupDelay = -1;
+}
+
+void
+TcpStreamQoe::OnSessionStart (uint16_t clientId, int64_t timeNow)
+{
+  m_metrics.clientId = clientId;
+  m_metrics.sessionStart = timeNow;
+}
+
+void
+TcpStreamQoe::OnPlayback (int64_t timeNow, int64_t repIndex, double bitrate, int64_t segmentDuration, int64_t liveLatency)
+{
+  if (m_metrics.startupDelay < 0)
+    {
+      m_metrics.startupDelay = timeNow - m_metrics.sessionStart;
+    }
+  if (m_lastRepIndex >= 0 && repIndex != m_lastRepIndex)
+    {
+      m_metrics.switchCount++;
+      m_metrics.switchMagnitudeSum += std::fabs (bitrate - m_lastBitrate);
+    }
+  m_lastRepIndex = repIndex;
+  m_lastBitrate = bitrate;
+  m_metrics.segmentsPlayed++;
+  m_metrics.bitrateSum += bitrate;
+  m_metrics.qualitySum += repIndex;
+  m_metrics.playbackTime += segmentDuration;
+  m_metrics.liveLatencySum += liveLatency;
+  m_metrics.liveLatencyMax = std::max (m_metrics.liveLatencyMax, liveLatency);
+}
+
+void
+TcpStreamQoe::OnStallStarted (int64_t timeNow)
+{
+  if (m_stallStart < 0)
+    {
+      m_stallStart = timeNow;
+      m_metrics.rebufferCount++;
+    }
+}
+
+void
+TcpStreamQoe::OnStallEnded (int64_t timeNow)
+{
+  if (m_stallStart >= 0)
+    {
+      m_metrics.rebufferTime += timeNow - m_stallStart;
+      m_stallStart = -1;
+    }
+}
+
+void
+TcpStreamQoe::Finish (int64_t timeNow)
+{
+  OnStallEnded (timeNow);
+}
+
+const qoeMetrics &
+TcpStreamQoe::GetMetrics () const
+{
+  return m_metrics;
+}
+
+TcpStreamQoeAggregator &
+TcpStreamQoeAggregator::Get ()
+{
+  static TcpStreamQoeAggregator aggregator;
+  return aggregator;
+}
+
+TcpStreamQoeAggregator::TcpStreamQoeAggregator ()
+{
+  for (size_t i = 0; i < g_percentileCount; i++)
+    {
+      m_rebufferRatio.push_back (P2Quantile (g_percentiles[i]));
+      m_startupDelay.push_back (P2Quantile (g_percentiles[i]));
+    }
+  Reset ();
+}
+
+void
+TcpStreamQoeAggregator::Reset ()
+{
+  m_simulationId = 0;
+  m_registered = 0;
+  m_reported = 0;
+  m_started = 0;
+  m_bitrateSum = 0;
+  m_bitrateSquareSum = 0;
+  m_startupDelaySum = 0;
+  m_rebufferRatioSum = 0;
+  m_switchSum = 0;
+  m_liveLatencySum = 0;
+  for (size_t i = 0; i < g_percentileCount; i++)
+    {
+      m_rebufferRatio.at (i).Reset ();
+      m_startupDelay.at (i).Reset ();
+    }
+  if (m_clientFile.is_open ())
+    {
+      m_clientFile.close ();
+    }
+}
+
+void
+TcpStreamQoeAggregator::Register (uint32_t simulationId)
+{
+  m_simulationId = simulationId;
+  m_registered++;
+}
+
+void
+TcpStreamQoeAggregator::Unregister ()
+{
+  if (m_registered > 0)
+    {
+      m_registered--;
+    }
+  if (m_registered > 0 && m_reported >= m_registered)
+    {
+      Write ();
+      Reset ();
+    }
+}
+
+void
+TcpStreamQoeAggregator::Report (const qoeMetrics &metrics)
+{
+  double averageBitrate = metrics.segmentsPlayed > 0 ? metrics.bitrateSum / metrics.segmentsPlayed : 0;
+  double rebufferRatio = metrics.playbackTime + metrics.rebufferTime > 0
+    ? metrics.rebufferTime / (double)(metrics.playbackTime + metrics.rebufferTime) : 0;
+  double liveLatency = metrics.segmentsPlayed > 0 ? metrics.liveLatencySum / metrics.segmentsPlayed / 1000000 : 0;
+
+  m_reported++;
+  m_bitrateSum += averageBitrate;
+  m_bitrateSquareSum += averageBitrate * averageBitrate;
+  m_rebufferRatioSum += rebufferRatio;
+  m_switchSum += metrics.switchCount;
+  m_liveLatencySum += liveLatency;
+  for (size_t i = 0; i < g_percentileCount; i++)
+    {
+      m_rebufferRatio.at (i).Add (rebufferRatio);
+    }
+  if (metrics.startupDelay >= 0)
+    {
+      m_started++;
+      m_startupDelaySum += metrics.startupDelay / (double)1000000;
+      for (size_t i = 0; i < g_percentileCount; i++)
+        {
+          m_startupDelay.at (i).Add (metrics.startupDelay / (double)1000000);
+        }
+    }
+
+  std::ostringstream line;
+  line << metrics.clientId << " "
+       << metrics.startupDelay / (double)1000000 << " "
+       << averageBitrate / 1000 << " "
+       << (metrics.segmentsPlayed > 0 ? metrics.qualitySum / metrics.segmentsPlayed : 0) << " "
+       << metrics.switchCount << " "
+       << (metrics.switchCount > 0 ? metrics.switchMagnitudeSum / metrics.switchCount / 1000 : 0) << " "
+       << metrics.rebufferCount << " "
+       << metrics.rebufferTime / (double)1000000 << " "
+       << rebufferRatio << " "
+       << liveLatency << " "
+       << metrics.liveLatencyMax / (double)1000000 << "\n";
+  if (!m_clientFile.is_open ())
+    {
+      std::string path = GetDirectory () + "qoeClients.txt";
+      m_clientFile.open (path.c_str ());
+      if (!m_clientFile)
+        {
+          NS_LOG_ERROR ("Could not open QoE client file " << path);
+        }
+      m_clientFile << "Client_Id Startup_Delay Average_Bitrate_Kbps Average_Quality Switches Mean_Switch_Kbps "
+                   << "Rebuffers Rebuffer_Time Rebuffer_Ratio Mean_Live_Latency Max_Live_Latency\n";
+    }
+  m_clientFile << line.str ();
+  m_clientFile.flush ();
+
+  if (m_reported >= m_registered)
+    {
+      Write ();
+      Reset ();
+    }
+}
+
+void
+TcpStreamQoeAggregator::Print (std::ostream &os) const
+{
+  double n = m_reported > 0 ? m_reported : 1;
+  double jain = m_bitrateSquareSum > 0 ? m_bitrateSum * m_bitrateSum / (m_reported * m_bitrateSquareSum) : 0;
+  os << "Clients " << m_reported << "\n"
+     << "Clients_Started " << m_started << "\n"
+     << "Mean_Average_Bitrate_Kbps " << m_bitrateSum / n / 1000 << "\n"
+     << "Jain_Fairness_Bitrate " << jain << "\n"
+     << "Mean_Switches " << m_switchSum / n << "\n"
+     << "Mean_Live_Latency " << m_liveLatencySum / n << "\n"
+     << "Mean_Startup_Delay " << (m_started > 0 ? m_startupDelaySum / m_started : 0) << "\n"
+     << "Startup_Delay_P50_P90_P95_P99";
+  for (size_t i = 0; i < g_percentileCount; i++)
+    {
+      os << " " << m_startupDelay.at (i).Get ();
+    }
+  os << "\n"
+     << "Mean_Rebuffer_Ratio " << m_rebufferRatioSum / n << "\n"
+     << "Rebuffer_Ratio_P50_P90_P95_P99";
+  for (size_t i = 0; i < g_percentileCount; i++)
+    {
+      os << " " << m_rebufferRatio.at (i).Get ();
+    }
+  os << "\n";
+}
+
+std::string
+TcpStreamQoeAggregator::GetDirectory () const
+{
+  std::ostringstream simulationId;
+  simulationId << m_simulationId;
+  return dashLogDirectory + "/SimID_" + simulationId.str () + "/";
+}
+
+void
+TcpStreamQoeAggregator::Write ()
+{
+  std::string path = GetDirectory () + "qoeSummary.txt";
+  std::ofstream file (path.c_str ());
+  if (!file)
+    {
+      NS_LOG_ERROR ("Could not open QoE summary file " << path);
+      return;
+    }
+  Print (file);
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_QOE_H
+#define TCP_STREAM_QOE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Streaming estimation of a single quantile with the P-square algorithm.
+ *
+ * R. Jain and I. Chlamtac, "The P2 algorithm for dynamic calculation of quantiles and histograms
+ * without storing observations", 1985. Uses five markers, i.e. constant memory and O(1) per sample.
+ */
+class P2Quantile
+{
+public:
+  P2Quantile (double quantile);
+  /**
+   * \brief Add an observation.
+   */
+  void Add (double x);
+  /**
+   * \return the current estimate of the quantile, 0 if there are no observations
+   */
+  double Get () const;
+  /**
+   * \brief Forget all observations.
+   */
+  void Reset ();
+
+private:
+  double Parabolic (int i, double d) const;
+  double Linear (int i, int d) const;
+
+  double m_quantile; //!< the quantile in (0, 1)
+  uint64_t m_count; //!< number of observations
+  double m_height[5]; //!< marker heights
+  double m_position[5]; //!< actual marker positions
+  double m_desired[5]; //!< desired marker positions
+  double m_increment[5]; //!< increments of the desired marker positions
+};
+
+/*! \class qoeMetrics tcp-stream-qoe.h "model/tcp-stream-qoe.h"
+ *  \ingroup tcpStream
+ *  \brief QoE metrics of one streaming session.
+ */
+struct qoeMetrics
+{
+  uint16_t clientId; //!< the client these metrics belong to
+  int64_t sessionStart; //!< simulation time in microseconds when the client started
+  int64_t startupDelay; //!< time in microseconds from session start to the start of playback, -1 if playback never started
+  int64_t segmentsPlayed; //!< number of segments whose playback started
+  double bitrateSum; //!< sum of the bitrates in bit/s of all played segments
+  double qualitySum; //!< sum of the representation indices of all played segments
+  int64_t switchCount; //!< number of quality switches between consecutively played segments
+  double switchMagnitudeSum; //!< sum of the absolute bitrate differences in bit/s of all switches
+  int64_t rebufferCount; //!< number of buffer underruns after playback started
+  int64_t rebufferTime; //!< total duration of buffer underruns in microseconds
+  int64_t playbackTime; //!< media time in microseconds that was played
+  double liveLatencySum; //!< sum of the live latencies in microseconds at the playback start of all segments
+  int64_t liveLatencyMax; //!< highest live latency in microseconds
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Online QoE accounting of one client.
+ *
+ * The client calls the On... methods on every playback, switch and underrun event, all metrics are
+ * updated incrementally in O(1), nothing is stored per segment.
+ */
+class TcpStreamQoe
+{
+public:
+  TcpStreamQoe ();
+  void OnSessionStart (uint16_t clientId, int64_t timeNow);
+  /**
+   * \brief Playback of a segment started.
+   *
+   * \param timeNow simulation time in microseconds
+   * \param repIndex representation index of the segment
+   * \param bitrate bitrate of the segment in bit/s
+   * \param segmentDuration media duration of the segment in microseconds
+   * \param liveLatency live latency in microseconds when the playback of the segment starts
+   */
+  void OnPlayback (int64_t timeNow, int64_t repIndex, double bitrate, int64_t segmentDuration, int64_t liveLatency);
+  void OnStallStarted (int64_t timeNow);
+  void OnStallEnded (int64_t timeNow);
+  /**
+   * \brief Close a running stall, so that the metrics are final.
+   */
+  void Finish (int64_t timeNow);
+  const qoeMetrics & GetMetrics () const;
+
+private:
+  qoeMetrics m_metrics; //!< the metrics
+  int64_t m_lastRepIndex; //!< representation index of the last played segment, -1 before playback started
+  double m_lastBitrate; //!< bitrate of the last played segment
+  int64_t m_stallStart; //!< start of the running stall, -1 if there is none
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief Per-process fleet level QoE statistics of a simulation run.
+ *
+ * Every client registers when it is initialised and reports its final metrics when its session
+ * ends or when it is disposed. The metrics of every client are appended to
+ * dashLogDirectory/SimID_<id>/qoeClients.txt as it reports, after the last registered client reported,
+ * one summary of the run is written to dashLogDirectory/SimID_<id>/qoeSummary.txt and the aggregator
+ * is reset. Only O(1) state is kept for the fleet: sums for the means and Jain's fairness index and
+ * P-square sketches for the percentiles.
+ */
+class TcpStreamQoeAggregator
+{
+public:
+  static TcpStreamQoeAggregator & Get ();
+  void Register (uint32_t simulationId);
+  /**
+   * \brief Withdraw a registration that will not be reported, e.g. the placeholder of a client arrival process.
+   */
+  void Unregister ();
+  void Report (const qoeMetrics &metrics);
+  /**
+   * \brief Write the fleet summary.
+   */
+  void Print (std::ostream &os) const;
+
+private:
+  TcpStreamQoeAggregator ();
+  void Reset ();
+  void Write ();
+
+  /**
+   * \return the output directory of the simulation, dashLogDirectory/SimID_<id>/
+   */
+  std::string GetDirectory () const;
+
+  uint32_t m_simulationId; //!< simulation id used for the output path
+  uint32_t m_registered; //!< number of registered clients
+  uint32_t m_reported; //!< number of clients that reported
+  uint32_t m_started; //!< number of clients whose playback started
+  double m_bitrateSum; //!< sum of the average bitrates of all clients
+  double m_bitrateSquareSum; //!< sum of the squared average bitrates of all clients
+  double m_startupDelaySum; //!< sum of the startup delays in seconds
+  double m_rebufferRatioSum; //!< sum of the rebuffer ratios
+  double m_switchSum; //!< sum of the switch counts
+  double m_liveLatencySum; //!< sum of the mean live latencies in seconds
+  std::vector<P2Quantile> m_rebufferRatio; //!< rebuffer ratio percentiles
+  std::vector<P2Quantile> m_startupDelay; //!< startup delay percentiles
+  std::ofstream m_clientFile; //!< the per client metrics, open from the first report until the reset
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_QOE_H */
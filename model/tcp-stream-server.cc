@@ -29,12 +29,17 @@
 #include "ns3/socket-factory.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
 #include "ns3/tcp-socket-factory.h"
 #include "tcp-stream-server.h"
 #include "ns3/global-value.h"
 #include <ns3/core-module.h>
 #include "tcp-stream-client.h"
+#include "tcp-stream-profiler.h"
+#include "tcp-stream-transport-registry.h"
 #include "ns3/trace-source-accessor.h"
+#include <fstream>
 
 namespace ns3 {
 
@@ -53,6 +58,26 @@ TcpStreamServer::GetTypeId (void)
                    UintegerValue (9),
                    MakeUintegerAccessor (&TcpStreamServer::m_port),
                    MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Profiling",
+                   "Count invocations, wall clock time and bytes of the server callbacks (see TcpStreamProfiler)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpStreamServer::m_profiling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TitleStatsFile",
+                   "The file the number of requests and bytes per video id are written to when the server is disposed, empty to disable",
+                   StringValue (""),
+                   MakeStringAccessor (&TcpStreamServer::m_titleStatsFile),
+                   MakeStringChecker ())
+    .AddAttribute ("StopWhenIdle",
+                   "Stop the simulation when the last connected client closed its connection, disable when clients arrive over time",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpStreamServer::m_stopWhenIdle),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TransportData",
+                   "Connect the trace sources of every accepted socket to the TcpStreamTransportRegistry, so that the clients' adaptation algorithms see the TCP state of their connection",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&TcpStreamServer::m_transportData),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -73,6 +98,8 @@ void
 TcpStreamServer::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  WriteTitleStats ();
+  m_titleStats.clear ();
   Application::DoDispose ();
 }
 
@@ -80,6 +107,10 @@ void
 TcpStreamServer::StartApplication (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_profiling)
+    {
+      TcpStreamProfiler::ScheduleDump ();
+    }
 
   if (m_socket == 0)
     {
@@ -128,14 +159,34 @@ void
 TcpStreamServer::HandleRead (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
+  DASH_PROFILE_SCOPE (profilerScope, SERVER_HANDLE_READ, m_profiling);
   Ptr<Packet> packet;
   Address from;
-  packet = socket->RecvFrom (from);
-  int64_t packetSizeToReturn = GetCommand (packet);
-  // these values will be accessible by the clients Address from.
-  m_callbackData [from].currentTxBytes = 0;
-  m_callbackData [from].packetSizeToReturn = packetSizeToReturn;
-  m_callbackData [from].send = true;
+  while ((packet = socket->RecvFrom (from)))
+    {
+      if (packet->GetSize () == 0)
+        {
+          break;
+        }
+      // these values will be accessible by the clients Address from.
+      callbackData &data = m_callbackData [from];
+      uint8_t *buffer = new uint8_t [packet->GetSize ()];
+      packet->CopyData (buffer, packet->GetSize ());
+      data.partial.append ((const char *) buffer, packet->GetSize ());
+      delete [] buffer;
+      // a packet may hold several pipelined requests, or only a part of one
+      std::string::size_type end;
+      while ((end = data.partial.find ('\0')) != std::string::npos)
+        {
+          int64_t videoId = 0;
+          int64_t packetSizeToReturn = GetCommand (data.partial.substr (0, end), videoId);
+          data.partial.erase (0, end + 1);
+          titleStats &stats = m_titleStats[videoId];
+          stats.requests++;
+          stats.bytes += packetSizeToReturn;
+          data.pending.push_back (packetSizeToReturn);
+        }
+    }
 
   HandleSend (socket, socket->GetTxAvailable ());
 
@@ -144,25 +195,40 @@ TcpStreamServer::HandleRead (Ptr<Socket> socket)
 void
 TcpStreamServer::HandleSend (Ptr<Socket> socket, uint32_t txSpace)
 {
+  DASH_PROFILE_SCOPE (profilerScope, SERVER_HANDLE_SEND, m_profiling);
   Address from;
   socket->GetPeerName (from);
   // look up values for the connected client and whose values are stored in from
-  if (m_callbackData [from].currentTxBytes == m_callbackData [from].packetSizeToReturn)
-    {
-      m_callbackData [from].currentTxBytes = 0;
-      m_callbackData [from].packetSizeToReturn = 0;
-      m_callbackData [from].send = false;
-      return;
-    }
-  if (socket->GetTxAvailable () > 0 && m_callbackData [from].send)
+  callbackData &data = m_callbackData [from];
+  while (true)
     {
+      if (data.currentTxBytes == data.packetSizeToReturn)
+        {
+          // the answer is complete, continue with the next pipelined request
+          data.currentTxBytes = 0;
+          data.packetSizeToReturn = 0;
+          data.send = false;
+          if (data.pending.empty ())
+            {
+              return;
+            }
+          data.packetSizeToReturn = data.pending.front ();
+          data.pending.pop_front ();
+          data.send = true;
+          continue;
+        }
+      if (socket->GetTxAvailable () == 0 || !data.send)
+        {
+          return;
+        }
       int32_t toSend;
-      toSend = std::min (socket->GetTxAvailable (), m_callbackData [from].packetSizeToReturn - m_callbackData [from].currentTxBytes);
+      toSend = std::min (socket->GetTxAvailable (), data.packetSizeToReturn - data.currentTxBytes);
       Ptr<Packet> packet = Create<Packet> (toSend);
       int amountSent = socket->Send (packet, 0);
       if (amountSent > 0)
         {
-          m_callbackData [from].currentTxBytes += amountSent;
+          data.currentTxBytes += amountSent;
+          DASH_PROFILE_BYTES (profilerScope, amountSent);
         }
       // We exit this part, when no bytes have been sent, as the send side buffer is full.
       // The "HandleSend" callback will fire when some buffer space has freed up.
@@ -185,6 +251,10 @@ TcpStreamServer::HandleAccept (Ptr<Socket> s, const Address& from)
   m_connectedClients.push_back (from);
   s->SetRecvCallback (MakeCallback (&TcpStreamServer::HandleRead, this));
   s->SetSendCallback ( MakeCallback (&TcpStreamServer::HandleSend, this));
+  if (m_transportData)
+    {
+      TcpStreamTransportRegistry::Get ().ConnectSocket (s, from);
+    }
 }
 
 void
@@ -198,8 +268,9 @@ TcpStreamServer::HandlePeerClose (Ptr<Socket> socket)
       if (*it == from)
         {
           m_connectedClients.erase (it);
+          m_callbackData.erase (from);
           // No more clients left in m_connectedClients, simulation is done.
-          if (m_connectedClients.size () == 0)
+          if (m_connectedClients.size () == 0 && m_stopWhenIdle)
             {
               Simulator::Stop ();
             }
@@ -212,20 +283,46 @@ void
 TcpStreamServer::HandlePeerError (Ptr<Socket> socket)
 {
   NS_LOG_FUNCTION (this << socket);
+  Address from;
+  socket->GetPeerName (from);
+  m_callbackData.erase (from);
 }
 
 int64_t
-TcpStreamServer::GetCommand (Ptr<Packet> packet)
+TcpStreamServer::GetCommand (const std::string &request, int64_t &videoId)
 {
-  int64_t packetSizeToReturn;
-  uint8_t *buffer = new uint8_t [packet->GetSize ()];
-  packet->CopyData (buffer, packet->GetSize ());
-  std::stringstream ss;
-  ss << buffer;
+  int64_t packetSizeToReturn = 0;
+  std::stringstream ss (request);
   std::string str;
   ss >> str;
   std::stringstream convert (str);
   convert >> packetSizeToReturn;
+  // requests of older clients carry no video id
+  if (!(ss >> videoId))
+    {
+      videoId = 0;
+    }
   return packetSizeToReturn;
 }
+
+void
+TcpStreamServer::WriteTitleStats ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_titleStatsFile.empty () || m_titleStats.empty ())
+    {
+      return;
+    }
+  std::ofstream file (m_titleStatsFile.c_str ());
+  if (!file)
+    {
+      NS_LOG_ERROR ("Could not open title statistics file " << m_titleStatsFile);
+      return;
+    }
+  file << "Video_Id Requests Bytes\n";
+  for (std::map<int64_t, titleStats>::const_iterator it = m_titleStats.begin (); it != m_titleStats.end (); ++it)
+    {
+      file << it->first << " " << it->second.requests << " " << it->second.bytes << "\n";
+    }
+}
 } // Namespace ns3
@@ -24,7 +24,9 @@
 #include "ns3/ptr.h"
 #include "ns3/address.h"
 #include "ns3/traced-callback.h"
+#include <deque>
 #include <map>
+#include <string>
 #include "ns3/random-variable-stream.h"
 
 namespace ns3 {
@@ -49,6 +51,19 @@ struct callbackData
   uint32_t currentTxBytes;//!< already sent bytes for this particular segment, set to 0 if sent bytes == packetSizeToReturn, so transmission for this segment is over
   uint32_t packetSizeToReturn;//!< total amount of bytes that have to be returned to the client
   bool send;//!< true as long as there are still bytes left to be sent for the current segment
+  std::deque<uint32_t> pending;//!< sizes of the pipelined requests that are answered after the current one, in order of arrival
+  std::string partial;//!< the beginning of a request whose end has not arrived yet
+};
+
+/**
+ * \ingroup tcpStream
+ * \brief request statistics of one title, identified by the video id the clients send with every request.
+ */
+struct titleStats
+{
+  titleStats () : requests (0), bytes (0) {}
+  uint64_t requests;//!< number of segment requests for this title
+  uint64_t bytes;//!< number of requested bytes for this title
 };
 
 /**
@@ -56,6 +71,8 @@ struct callbackData
  * \brief A Tcp Stream server
  *
  * Clients sent messages with the amount of bytes they want the server to return to them.
+ * Requests are null terminated strings; a client may pipeline several requests on its connection,
+ * they are answered one after the other in the order they arrived.
  */
 class TcpStreamServer : public Application
 {
@@ -78,10 +95,10 @@ private:
   /**
    * \brief Handle a packet reception, and set SendCallback to HandlSend.
    *
-   * This function is called by lower layers. The received packet's content
-   * gets deserialized by GetCommand (Ptr<Packet> packet). If the packets content
-   * contains a string composed of an int with
-   * value n, then n bytes will be sent back to the sender.
+   * This function is called by lower layers. The received bytes are split into requests
+   * at their null terminators, every request gets deserialized by GetCommand (). If a request
+   * contains a string composed of an int with value n, then n bytes will be sent back to the
+   * sender, after the answers to its earlier requests.
    *
    * \param socket the socket the packet was received to.
    */
@@ -119,16 +136,27 @@ private:
 
   /**
    * \brief Deserialize what the client has sent us.
-   * \param packet the data the client has sent us
-   * \return the deserialized packet content as a string
+   * \param request one request of the client, the number of bytes to return, optionally followed by the video id
+   * \param videoId set to the video id of the request, 0 if there is none
+   * \return the number of bytes to return
+   */
+  int64_t GetCommand (const std::string &request, int64_t &videoId);
+
+  /**
+   * \brief Write the number of requests and bytes per video id to m_titleStatsFile.
    */
-  int64_t GetCommand (Ptr<Packet> packet);
+  void WriteTitleStats ();
 
   uint16_t m_port; //!< Port on which we listen for incoming packets.
   Ptr<Socket> m_socket; //!< IPv4 Socket
   Ptr<Socket> m_socket6; //!< IPv6 Socket
   std::map <Address, callbackData> m_callbackData; //!< With this it is possible to access the currentTxBytes, the packetSizeToReturn and the send boolean through the from value of the client.
   std::vector<Address> m_connectedClients; //!< Vector which holds the list of currently connected clients.
+  bool m_profiling; //!< True if the server callbacks are counted by TcpStreamProfiler
+  bool m_stopWhenIdle; //!< True if the simulation stops when the last connected client closed its connection
+  bool m_transportData; //!< True if the TCP state of the accepted sockets is passed to the clients (see TcpStreamTransportRegistry)
+  std::string m_titleStatsFile; //!< The file the per title statistics are written to, empty to disable
+  std::map <int64_t, titleStats> m_titleStats; //!< Requests and bytes per video id
 
 
 };
@@ -0,0 +1,318 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-stats-sampler.h"
+#include "tcp-stream-client.h"
+#include "tcp-stream-churn-manager.h"
+#include "tcp-stream-interface.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamStatsSampler");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpStreamStatsSampler);
+
+static const char * const g_metricNames[TcpStreamStatsSampler::METRIC_COUNT] = {
+  "throughput",
+  "bufferLevel",
+  "quality",
+  "liveLatency"
+};
+
+TypeId
+TcpStreamStatsSampler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpStreamStatsSampler")
+    .SetParent<Object> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<TcpStreamStatsSampler> ()
+    .AddAttribute ("Interval",
+                   "The time between two samples of the client metrics",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&TcpStreamStatsSampler::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Decimation",
+                   "The number of samples that are averaged into one output value",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&TcpStreamStatsSampler::m_decimation),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Mode",
+                   "Write one time series per client (PerClient) or the mean over all streaming clients (Fleet)",
+                   EnumValue (FLEET),
+                   MakeEnumAccessor (&TcpStreamStatsSampler::m_mode),
+                   MakeEnumChecker (PER_CLIENT, "PerClient",
+                                    FLEET, "Fleet"))
+    .AddAttribute ("SimulationId",
+                   "The ID of the current simulation, for the output path",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&TcpStreamStatsSampler::m_simulationId),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("StopTime",
+                   "No samples are taken after this point in time, 0 to sample until all sessions ended",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TcpStreamStatsSampler::m_stopTime),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TcpStreamStatsSampler::TcpStreamStatsSampler ()
+  : m_samples (0),
+    m_activeChurns (0),
+    m_started (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpStreamStatsSampler::~TcpStreamStatsSampler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TcpStreamStatsSampler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sampleEvent);
+  m_clients.clear ();
+  m_fleetSeries.clear ();
+  Object::DoDispose ();
+}
+
+void
+TcpStreamStatsSampler::AddClient (Ptr<TcpStreamClient> client)
+{
+  NS_LOG_FUNCTION (this << client);
+  UintegerValue clientId;
+  client->GetAttribute ("ClientId", clientId);
+  client->TraceConnectWithoutContext ("SessionEnded", MakeCallback (&TcpStreamStatsSampler::SessionEnded, this));
+  sampledClient sampled;
+  sampled.client = client;
+  sampled.clientId = clientId.Get ();
+  sampled.lastBytes = client->GetTotalBytesReceived ();
+  if (m_started && m_mode == PER_CLIENT)
+    {
+      AddClientSeries (sampled);
+    }
+  m_clients.push_back (sampled);
+}
+
+void
+TcpStreamStatsSampler::FollowChurn (Ptr<TcpStreamChurnManager> manager)
+{
+  NS_LOG_FUNCTION (this << manager);
+  manager->TraceConnectWithoutContext ("ClientArrived", MakeCallback (&TcpStreamStatsSampler::AddClient, this));
+  manager->TraceConnectWithoutContext ("LastSessionEnded", MakeCallback (&TcpStreamStatsSampler::ChurnEnded, this));
+  m_activeChurns++;
+}
+
+TcpStreamStatsSampler::series
+TcpStreamStatsSampler::CreateSeries (std::string fileName, std::string context) const
+{
+  series s;
+  s.probe = CreateObject<DoubleProbe> ();
+  s.probe->SetName (context);
+  s.adaptor = CreateObject<TimeSeriesAdaptor> ();
+  s.aggregator = CreateObject<FileAggregator> (fileName, FileAggregator::SPACE_SEPARATED);
+  s.probe->TraceConnectWithoutContext ("Output", MakeCallback (&TimeSeriesAdaptor::TraceSinkDouble, s.adaptor));
+  s.adaptor->TraceConnect ("Output", context, MakeCallback (&FileAggregator::Write2d, s.aggregator));
+  s.probe->Enable ();
+  s.aggregator->Enable ();
+  s.sum = 0;
+  s.count = 0;
+  return s;
+}
+
+void
+TcpStreamStatsSampler::AddClientSeries (sampledClient &sampled) const
+{
+  std::ostringstream prefix;
+  prefix << dashLogDirectory << "/SimID_" << m_simulationId << "/";
+  for (int m = 0; m < METRIC_COUNT; m++)
+    {
+      std::ostringstream context;
+      context << "client" << sampled.clientId << "_" << g_metricNames[m];
+      sampled.metrics.push_back (CreateSeries (prefix.str () + context.str () + "Stats.txt", context.str ()));
+    }
+}
+
+void
+TcpStreamStatsSampler::Flush (series &s) const
+{
+  if (s.count > 0)
+    {
+      s.probe->SetValue (s.sum / s.count);
+      s.sum = 0;
+      s.count = 0;
+    }
+}
+
+void
+TcpStreamStatsSampler::Start ()
+{
+  NS_LOG_FUNCTION (this);
+  m_started = true;
+  if (m_mode == PER_CLIENT)
+    {
+      for (uint32_t i = 0; i < m_clients.size (); i++)
+        {
+          AddClientSeries (m_clients.at (i));
+        }
+    }
+  else
+    {
+      std::ostringstream prefix;
+      prefix << dashLogDirectory << "/SimID_" << m_simulationId << "/";
+      for (int m = 0; m < METRIC_COUNT; m++)
+        {
+          std::string context = std::string ("fleet_") + g_metricNames[m];
+          m_fleetSeries.push_back (CreateSeries (prefix.str () + context + "Stats.txt", context));
+        }
+    }
+  if (IsDone ())
+    {
+      NS_LOG_WARN ("Nothing to sample: no clients, no churn manager and no StopTime");
+      return;
+    }
+  m_sampleEvent = Simulator::Schedule (m_interval, &TcpStreamStatsSampler::Sample, this);
+}
+
+void
+TcpStreamStatsSampler::Stop ()
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_sampleEvent);
+}
+
+void
+TcpStreamStatsSampler::SessionEnded (uint16_t clientId)
+{
+  NS_LOG_FUNCTION (this << clientId);
+  for (uint32_t i = 0; i < m_clients.size (); i++)
+    {
+      if (m_clients.at (i).clientId == clientId)
+        {
+          // write the samples of the last, incomplete decimation period, then drop the series, which
+          // closes their files, and the client, as churn clients are disposed right after their session
+          std::vector<series> &metrics = m_clients.at (i).metrics;
+          for (uint32_t m = 0; m < metrics.size (); m++)
+            {
+              Flush (metrics.at (m));
+              metrics.at (m).aggregator->Disable ();
+            }
+          std::swap (m_clients.at (i), m_clients.back ());
+          m_clients.pop_back ();
+          break;
+        }
+    }
+  if (IsDone ())
+    {
+      Stop ();
+    }
+}
+
+void
+TcpStreamStatsSampler::ChurnEnded ()
+{
+  NS_LOG_FUNCTION (this);
+  m_activeChurns--;
+  if (IsDone ())
+    {
+      Stop ();
+    }
+}
+
+bool
+TcpStreamStatsSampler::IsDone () const
+{
+  if (!m_stopTime.IsZero ())
+    {
+      return Simulator::Now () + m_interval > m_stopTime;
+    }
+  return m_clients.empty () && m_activeChurns == 0;
+}
+
+void
+TcpStreamStatsSampler::Sample ()
+{
+  NS_LOG_FUNCTION (this);
+  double fleet[METRIC_COUNT] = {};
+  uint32_t streaming = 0;
+  for (uint32_t i = 0; i < m_clients.size (); i++)
+    {
+      sampledClient &sampled = m_clients.at (i);
+      uint64_t bytes = sampled.client->GetTotalBytesReceived ();
+      double value[METRIC_COUNT];
+      value[THROUGHPUT] = (bytes - sampled.lastBytes) * 8 / m_interval.GetSeconds ();
+      sampled.lastBytes = bytes;
+      if (!sampled.client->IsStreaming ())
+        {
+          continue;
+        }
+      streaming++;
+      value[BUFFER_LEVEL] = sampled.client->GetBufferLevel () / (double)1000000;
+      value[QUALITY] = sampled.client->GetPlaybackRepIndex ();
+      value[LIVE_LATENCY] = sampled.client->GetLiveLatency () / (double)1000000;
+      for (int m = 0; m < METRIC_COUNT; m++)
+        {
+          if (m_mode == PER_CLIENT)
+            {
+              series &s = sampled.metrics.at (m);
+              s.sum += value[m];
+              s.count++;
+            }
+          else
+            {
+              fleet[m] += value[m];
+            }
+        }
+    }
+  if (m_mode == FLEET && streaming > 0)
+    {
+      for (int m = 0; m < METRIC_COUNT; m++)
+        {
+          m_fleetSeries.at (m).sum += fleet[m] / streaming;
+          m_fleetSeries.at (m).count++;
+        }
+    }
+
+  if (++m_samples % m_decimation == 0)
+    {
+      for (uint32_t i = 0; i < m_clients.size (); i++)
+        {
+          for (uint32_t m = 0; m < m_clients.at (i).metrics.size (); m++)
+            {
+              Flush (m_clients.at (i).metrics.at (m));
+            }
+        }
+      for (uint32_t m = 0; m < m_fleetSeries.size (); m++)
+        {
+          Flush (m_fleetSeries.at (m));
+        }
+    }
+
+  // the fleet may be empty between two churn arrivals, so only StopTime and the session ends stop sampling
+  if (!IsDone ())
+    {
+      m_sampleEvent = Simulator::Schedule (m_interval, &TcpStreamStatsSampler::Sample, this);
+    }
+}
+
+} // namespace ns3
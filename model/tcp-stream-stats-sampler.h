@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_STATS_SAMPLER_H
+#define TCP_STREAM_STATS_SAMPLER_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/double-probe.h"
+#include "ns3/time-series-adaptor.h"
+#include "ns3/file-aggregator.h"
+#include <vector>
+
+namespace ns3 {
+
+class TcpStreamClient;
+class TcpStreamChurnManager;
+
+/**
+ * \ingroup tcpStream
+ * \brief Periodically samples the metrics of tcp stream clients into the ns-3 stats framework.
+ *
+ * A single event samples the throughput, buffer level, playback quality and live latency of all
+ * added clients every Interval. Decimation samples are averaged and written to a DoubleProbe, whose
+ * output is converted into a time series by a TimeSeriesAdaptor and written by a FileAggregator.
+ * In Mode PerClient, there is one probe per client and metric (files client<id>_<metric>Stats.txt),
+ * in Mode Fleet one probe per metric holding the mean over all streaming clients (files
+ * fleet_<metric>Stats.txt), both in dashLogDirectory/SimID_<id>/. The output volume thus only depends
+ * on the simulated time, Interval and Decimation, not on the number of segments or packets. As the
+ * probes only fire on changes, repeated values are not written again.
+ *
+ * Sampling ends at StopTime, when Stop () is called, or once every added client ended its session and
+ * every followed churn manager reported that its last session ended. Clients of a followed churn manager
+ * are added when they arrive. When the session of a client ended, it is released and, in Mode PerClient,
+ * its files are closed, so that the cost of sampling follows the number of concurrent clients.
+ */
+class TcpStreamStatsSampler : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TcpStreamStatsSampler ();
+  virtual ~TcpStreamStatsSampler ();
+
+  /**
+   * \brief The aggregation modes.
+   */
+  enum Mode
+  {
+    PER_CLIENT, FLEET
+  };
+
+  /**
+   * \brief The sampled metrics.
+   */
+  enum Metric
+  {
+    THROUGHPUT, BUFFER_LEVEL, QUALITY, LIVE_LATENCY, METRIC_COUNT
+  };
+
+  /**
+   * \brief Sample the given client until its session ended.
+   */
+  void AddClient (Ptr<TcpStreamClient> client);
+  /**
+   * \brief Sample the clients of the given churn manager, and keep sampling until its last session ended.
+   */
+  void FollowChurn (Ptr<TcpStreamChurnManager> manager);
+  /**
+   * \brief Create the probes, adaptors and aggregators and schedule the first sample.
+   */
+  void Start ();
+  /**
+   * \brief Stop sampling.
+   */
+  void Stop ();
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A probe with its adaptor and aggregator, plus the running decimation sum.
+   */
+  struct series
+  {
+    Ptr<DoubleProbe> probe; //!< the probe
+    Ptr<TimeSeriesAdaptor> adaptor; //!< converts the probe output into (time, value)
+    Ptr<FileAggregator> aggregator; //!< writes the time series
+    double sum; //!< sum of the samples since the last probe update
+    uint32_t count; //!< number of samples since the last probe update
+  };
+
+  /**
+   * \brief A client whose session did not end yet.
+   */
+  struct sampledClient
+  {
+    Ptr<TcpStreamClient> client; //!< the client application
+    uint16_t clientId; //!< the id of the client
+    uint64_t lastBytes; //!< bytes received at the last sample
+    std::vector<series> metrics; //!< METRIC_COUNT series in PER_CLIENT mode, empty in FLEET mode
+  };
+
+  series CreateSeries (std::string fileName, std::string context) const;
+  /**
+   * \brief Create the PER_CLIENT series of the given client.
+   */
+  void AddClientSeries (sampledClient &sampled) const;
+  /**
+   * \brief Write the mean of the samples since the last probe update, if there are any.
+   */
+  void Flush (series &s) const;
+  void Sample ();
+  /**
+   * \brief Trace sink of the SessionEnded trace source of the clients.
+   */
+  void SessionEnded (uint16_t clientId);
+  /**
+   * \brief Trace sink of the LastSessionEnded trace source of the churn managers.
+   */
+  void ChurnEnded ();
+  /**
+   * \return true if no more samples are needed
+   */
+  bool IsDone () const;
+
+  Time m_interval; //!< time between two samples
+  uint32_t m_decimation; //!< number of samples averaged into one probe value
+  Mode m_mode; //!< per client or fleet wide aggregation
+  uint16_t m_simulationId; //!< the Id of this simulation, for the output path
+  Time m_stopTime; //!< no samples after this point in time, 0 for no limit
+  std::vector<sampledClient> m_clients; //!< the sampled clients, removed when their session ended
+  std::vector<series> m_fleetSeries; //!< METRIC_COUNT series in FLEET mode, empty in PER_CLIENT mode
+  uint32_t m_samples; //!< number of samples taken
+  uint32_t m_activeChurns; //!< number of followed churn managers whose last session did not end yet
+  bool m_started; //!< true once Start () was called
+  EventId m_sampleEvent; //!< the next sample
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_STATS_SAMPLER_H */
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-transport-registry.h"
+#include "ns3/callback.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamTransportRegistry");
+
+// a connection without acknowledgements for this many smoothed round trip times was idle
+static const int64_t idleRtts = 2;
+// the number of delivery rate samples kept per connection
+static const uint32_t maxDeliverySamples = 256;
+
+TcpStreamTransportRegistry &
+TcpStreamTransportRegistry::Get ()
+{
+  static TcpStreamTransportRegistry registry;
+  return registry;
+}
+
+TcpStreamTransportRegistry::TcpStreamTransportRegistry ()
+{
+}
+
+void
+TcpStreamTransportRegistry::Register (const Address &client, transportData *data)
+{
+  NS_LOG_FUNCTION (this << client);
+  m_clients[client] = data;
+}
+
+void
+TcpStreamTransportRegistry::Unregister (const Address &client)
+{
+  NS_LOG_FUNCTION (this << client);
+  m_clients.erase (client);
+}
+
+void
+TcpStreamTransportRegistry::ConnectSocket (Ptr<Socket> socket, const Address &client)
+{
+  NS_LOG_FUNCTION (this << socket << client);
+  socket->TraceConnectWithoutContext ("CongestionWindow",
+                                      MakeBoundCallback (&TcpStreamTransportRegistry::CongestionWindowChanged, client));
+  socket->TraceConnectWithoutContext ("RTT",
+                                      MakeBoundCallback (&TcpStreamTransportRegistry::RttChanged, client));
+  socket->TraceConnectWithoutContext ("BytesInFlight",
+                                      MakeBoundCallback (&TcpStreamTransportRegistry::BytesInFlightChanged, client));
+  socket->TraceConnectWithoutContext ("HighestRxAck",
+                                      MakeBoundCallback (&TcpStreamTransportRegistry::HighestRxAckChanged, client));
+}
+
+transportData *
+TcpStreamTransportRegistry::Find (const Address &client)
+{
+  if (m_clients.empty ())
+    {
+      return 0;
+    }
+  std::map<Address, transportData *>::iterator it = m_clients.find (client);
+  return it == m_clients.end () ? 0 : it->second;
+}
+
+void
+TcpStreamTransportRegistry::CongestionWindowChanged (Address client, uint32_t oldValue, uint32_t newValue)
+{
+  transportData *data = Get ().Find (client);
+  if (data == 0)
+    {
+      return;
+    }
+  data->congestionWindow = newValue;
+  data->lastUpdate = Simulator::Now ().GetMicroSeconds ();
+}
+
+void
+TcpStreamTransportRegistry::RttChanged (Address client, Time oldValue, Time newValue)
+{
+  transportData *data = Get ().Find (client);
+  int64_t rtt = newValue.GetMicroSeconds ();
+  if (data == 0 || rtt <= 0)
+    {
+      return;
+    }
+  data->lastRtt = rtt;
+  data->smoothedRtt = data->smoothedRtt == 0 ? rtt : (7 * data->smoothedRtt + rtt) / 8;
+  data->lastUpdate = Simulator::Now ().GetMicroSeconds ();
+}
+
+void
+TcpStreamTransportRegistry::BytesInFlightChanged (Address client, uint32_t oldValue, uint32_t newValue)
+{
+  transportData *data = Get ().Find (client);
+  if (data == 0)
+    {
+      return;
+    }
+  data->bytesInFlight = newValue;
+  data->lastUpdate = Simulator::Now ().GetMicroSeconds ();
+}
+
+void
+TcpStreamTransportRegistry::HighestRxAckChanged (Address client, SequenceNumber32 oldValue, SequenceNumber32 newValue)
+{
+  transportData *data = Get ().Find (client);
+  int32_t acked = newValue - oldValue;
+  if (data == 0 || acked <= 0)
+    {
+      return;
+    }
+  int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  data->lastUpdate = timeNow;
+  bool idle = data->smoothedRtt == 0 || timeNow - data->lastAckTime > idleRtts * data->smoothedRtt;
+  data->lastAckTime = timeNow;
+  if (idle)
+    {
+      // the data acknowledged now was sent after the idle period, start a new sample
+      data->sampleStart = timeNow;
+      data->sampleBytes = 0;
+      return;
+    }
+  data->sampleBytes += acked;
+  int64_t interval = timeNow - data->sampleStart;
+  if (interval < data->smoothedRtt)
+    {
+      return;
+    }
+  data->deliveryRateTime.push_back (timeNow);
+  data->deliveryRate.push_back (data->sampleBytes * 8 / (interval / 1000000.0));
+  data->sampleStart = timeNow;
+  data->sampleBytes = 0;
+  // drop the oldest half at once, so that trimming costs O(1) per sample
+  if (data->deliveryRate.size () >= 2 * maxDeliverySamples)
+    {
+      data->deliveryRateTime.erase (data->deliveryRateTime.begin (), data->deliveryRateTime.end () - maxDeliverySamples);
+      data->deliveryRate.erase (data->deliveryRate.begin (), data->deliveryRate.end () - maxDeliverySamples);
+    }
+}
+
+} // namespace ns3
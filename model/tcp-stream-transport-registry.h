@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_TRANSPORT_REGISTRY_H
+#define TCP_STREAM_TRANSPORT_REGISTRY_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/sequence-number.h"
+#include "tcp-stream-interface.h"
+
+namespace ns3 {
+
+class Socket;
+
+/**
+ * \ingroup tcpStream
+ * \brief Per-process link between the TCP state of the server's sockets and the clients.
+ *
+ * The sender side state of a connection (congestion window, round trip time, bytes in flight and
+ * acknowledged bytes) is only known to the server's socket. The server connects the trace sources of
+ * every accepted socket with ConnectSocket (), and every client registers its transportData under its
+ * own address, which is the peer address the server sees. The trace sinks update the registered
+ * transportData in place, events of connections whose client is not registered are dropped.
+ */
+class TcpStreamTransportRegistry
+{
+public:
+  static TcpStreamTransportRegistry & Get ();
+
+  /**
+   * \param client the address of the client's socket
+   * \param data the transportData of the client, it must stay valid until Unregister () is called
+   */
+  void Register (const Address &client, transportData *data);
+  /**
+   * \param client the address of the client's socket
+   */
+  void Unregister (const Address &client);
+  /**
+   * \brief Connect the trace sources of a TCP socket of the server.
+   *
+   * \param socket the socket accepted by the server
+   * \param client the peer address of the socket
+   */
+  void ConnectSocket (Ptr<Socket> socket, const Address &client);
+
+private:
+  TcpStreamTransportRegistry ();
+
+  /**
+   * \return the transportData registered for client, 0 if there is none
+   */
+  transportData * Find (const Address &client);
+
+  static void CongestionWindowChanged (Address client, uint32_t oldValue, uint32_t newValue);
+  static void RttChanged (Address client, Time oldValue, Time newValue);
+  static void BytesInFlightChanged (Address client, uint32_t oldValue, uint32_t newValue);
+  static void HighestRxAckChanged (Address client, SequenceNumber32 oldValue, SequenceNumber32 newValue);
+
+  std::map<Address, transportData *> m_clients; //!< the transportData of the registered clients by their address
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_TRANSPORT_REGISTRY_H */
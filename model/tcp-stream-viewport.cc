@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "tcp-stream-viewport.h"
+#include "ns3/log.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpStreamViewport");
+
+static const int64_t g_sampleInterval = 100000;
+static const double g_maxPitch = 30; //!< the synthetic viewer looks at most this far up or down
+
+/**
+ * \return the yaw difference b - a in degrees along the shorter way, in [-180, 180)
+ */
+static double
+YawDifference (double a, double b)
+{
+  double d = std::fmod (b - a + 180, 360);
+  if (d < 0)
+    {
+      d += 360;
+    }
+  return d - 180;
+}
+
+/**
+ * \return the length of the overlap of [a0, a1] and [b0, b1]
+ */
+static double
+Overlap (double a0, double a1, double b0, double b1)
+{
+  return std::max (0.0, std::min (a1, b1) - std::max (a0, b0));
+}
+
+TcpStreamViewport::TcpStreamViewport ()
+{
+}
+
+bool
+TcpStreamViewport::Load (std::string traceFile)
+{
+  NS_LOG_FUNCTION (this << traceFile);
+  std::ifstream file (traceFile.c_str ());
+  if (!file)
+    {
+      return false;
+    }
+  m_time.clear ();
+  m_yaw.clear ();
+  m_pitch.clear ();
+  std::string line;
+  while (std::getline (file, line))
+    {
+      std::istringstream buffer (line);
+      double time, yaw, pitch;
+      if (!(buffer >> time >> yaw >> pitch))
+        {
+          continue;
+        }
+      m_time.push_back ((int64_t)(time * 1000000));
+      m_yaw.push_back (yaw);
+      m_pitch.push_back (std::min (std::max (pitch, -90.0), 90.0));
+    }
+  return !m_time.empty ();
+}
+
+void
+TcpStreamViewport::Generate (int64_t duration, double speed, int64_t dwell, Ptr<UniformRandomVariable> uniform)
+{
+  NS_LOG_FUNCTION (this << duration << speed << dwell);
+  m_time.clear ();
+  m_yaw.clear ();
+  m_pitch.clear ();
+  double yaw = 0;
+  double pitch = 0;
+  double targetYaw = 0;
+  double targetPitch = 0;
+  int64_t dwellEnd = (int64_t)(-dwell * std::log (1 - uniform->GetValue ()));
+  double step = speed * g_sampleInterval / 1000000.0;
+  for (int64_t time = 0; time <= duration; time += g_sampleInterval)
+    {
+      m_time.push_back (time);
+      m_yaw.push_back (yaw);
+      m_pitch.push_back (pitch);
+      if (time < dwellEnd)
+        {
+          continue;
+        }
+      double dYaw = YawDifference (yaw, targetYaw);
+      double dPitch = targetPitch - pitch;
+      double distance = std::sqrt (dYaw * dYaw + dPitch * dPitch);
+      if (distance <= step)
+        {
+          // arrived, look at this direction for a while and pick the next one
+          yaw = targetYaw;
+          pitch = targetPitch;
+          dwellEnd = time + (int64_t)(-dwell * std::log (1 - uniform->GetValue ()));
+          targetYaw = uniform->GetValue () * 360 - 180;
+          targetPitch = (uniform->GetValue () * 2 - 1) * g_maxPitch;
+          continue;
+        }
+      yaw += dYaw * step / distance;
+      yaw = YawDifference (0, yaw);
+      pitch += dPitch * step / distance;
+    }
+}
+
+void
+TcpStreamViewport::GetViewport (int64_t mediaTime, double &yaw, double &pitch) const
+{
+  if (m_time.empty ())
+    {
+      yaw = 0;
+      pitch = 0;
+      return;
+    }
+  std::vector<int64_t>::const_iterator it = std::upper_bound (m_time.begin (), m_time.end (), mediaTime);
+  if (it == m_time.begin () || it == m_time.end ())
+    {
+      // hold the first or last sample outside the trace
+      size_t i = it == m_time.begin () ? 0 : m_time.size () - 1;
+      yaw = m_yaw.at (i);
+      pitch = m_pitch.at (i);
+      return;
+    }
+  size_t i = it - m_time.begin ();
+  double share = (mediaTime - m_time.at (i - 1)) / (double)(m_time.at (i) - m_time.at (i - 1));
+  yaw = YawDifference (0, m_yaw.at (i - 1) + share * YawDifference (m_yaw.at (i - 1), m_yaw.at (i)));
+  pitch = m_pitch.at (i - 1) + share * (m_pitch.at (i) - m_pitch.at (i - 1));
+}
+
+void
+TcpStreamViewport::GetTileWeights (int64_t mediaTime, int64_t rows, int64_t columns, double fovYaw, double fovPitch,
+                                   std::vector<double> &weights) const
+{
+  double yaw, pitch;
+  GetViewport (mediaTime, yaw, pitch);
+  double tileWidth = 360.0 / columns;
+  double tileHeight = 180.0 / rows;
+  double top = std::min (pitch + fovPitch / 2, 90.0);
+  double bottom = std::max (pitch - fovPitch / 2, -90.0);
+  weights.assign (rows * columns, 0);
+  for (int64_t column = 0; column < columns; column++)
+    {
+      double left = -180 + column * tileWidth;
+      // the viewport may wrap around yaw -180 / 180
+      double width = 0;
+      for (int shift = -1; shift <= 1; shift++)
+        {
+          width += Overlap (left, left + tileWidth, yaw - fovYaw / 2 + shift * 360, yaw + fovYaw / 2 + shift * 360);
+        }
+      if (width == 0)
+        {
+          continue;
+        }
+      for (int64_t row = 0; row < rows; row++)
+        {
+          double tileTop = 90 - row * tileHeight;
+          double height = Overlap (tileTop - tileHeight, tileTop, bottom, top);
+          weights.at (row * columns + column) = std::min (1.0, width * height / (tileWidth * tileHeight));
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_STREAM_VIEWPORT_H
+#define TCP_STREAM_VIEWPORT_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief The head movement of a viewer of a 360 degree video, over media time.
+ *
+ * The viewport trace is a sequence of (media time, yaw, pitch) samples, yaw in [-180, 180) and pitch in
+ * [-90, 90] degrees, between which the viewport is interpolated along the shorter way. A trace is either
+ * read from a file or generated: the synthetic viewer looks at a random direction for a dwell time,
+ * then turns to the next one at a constant angular speed.
+ */
+class TcpStreamViewport
+{
+public:
+  TcpStreamViewport ();
+  /**
+   * \brief Read a viewport trace file, one sample per line: media time in seconds, yaw and pitch in degrees.
+   *
+   * \param traceFile the trace file
+   * \return false if the file can't be read or has no samples
+   */
+  bool Load (std::string traceFile);
+  /**
+   * \brief Generate a synthetic trace with one sample per 100 ms.
+   *
+   * \param duration the media time in microseconds the trace covers
+   * \param speed the angular speed in degrees per second while the viewer turns
+   * \param dwell the mean time in microseconds the viewer looks at one direction, exponentially distributed
+   * \param uniform the random numbers of the trace, so that it depends on the run and stream number only
+   */
+  void Generate (int64_t duration, double speed, int64_t dwell, Ptr<UniformRandomVariable> uniform);
+  /**
+   * \brief The share of every tile of an equirectangular tile grid that lies in the viewport.
+   *
+   * \param mediaTime the media time in microseconds
+   * \param rows the number of tile rows, row 0 at pitch 90
+   * \param columns the number of tile columns, column 0 at yaw -180
+   * \param fovYaw the horizontal field of view in degrees
+   * \param fovPitch the vertical field of view in degrees
+   * \param weights set to the share of the area of every tile in the viewport, row by row
+   */
+  void GetTileWeights (int64_t mediaTime, int64_t rows, int64_t columns, double fovYaw, double fovPitch,
+                       std::vector<double> &weights) const;
+
+private:
+  /**
+   * \brief Interpolate the viewport at a media time.
+   */
+  void GetViewport (int64_t mediaTime, double &yaw, double &pitch) const;
+
+  std::vector<int64_t> m_time; //!< media time in microseconds of every sample, ascending
+  std::vector<double> m_yaw; //!< yaw in degrees of every sample
+  std::vector<double> m_pitch; //!< pitch in degrees of every sample
+};
+
+} // namespace ns3
+
+#endif /* TCP_STREAM_VIEWPORT_H */
@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tile.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TileAlgorithm");
+
+NS_OBJECT_ENSURE_REGISTERED (TileAlgorithm);
+
+TypeId
+TileAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TileAlgorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("Safety",
+                   "The share of the estimated throughput the tiles of a segment may use",
+                   DoubleValue (0.9),
+                   MakeDoubleAccessor (&TileAlgorithm::m_safety),
+                   MakeDoubleChecker<double> (0.01, 1))
+    .AddAttribute ("Window",
+                   "The number of segments of the harmonic mean of the throughput",
+                   UintegerValue (5),
+                   MakeUintegerAccessor (&TileAlgorithm::m_window),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("OutsideWeight",
+                   "The utility weight of every tile in addition to its predicted viewport share",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&TileAlgorithm::m_outsideWeight),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ReservoirBuffer",
+                   "The buffer level in microseconds below which the budget is scaled down by the share of the buffer level",
+                   UintegerValue (4000000),
+                   MakeUintegerAccessor (&TileAlgorithm::m_reservoirBuffer),
+                   MakeUintegerChecker<uint64_t> ())
+  ;
+  return tid;
+}
+
+TileAlgorithm::TileAlgorithm (  const videoData &videoData,
+                                const playbackData & playbackData,
+                                const bufferData & bufferData,
+                                const throughputData & throughput) :
+  AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
+  m_highestRepIndex (videoData.averageBitrate.size () - 1)
+{
+  NS_LOG_INFO (this);
+  NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
+}
+
+algorithmReply
+TileAlgorithm::GetNextRep (const int64_t segmentCounter, int64_t clientId)
+{
+  const int64_t timeNow = Simulator::Now ().GetMicroSeconds ();
+  algorithmReply answer;
+  answer.decisionTime = timeNow;
+  const int64_t tiles = m_videoData.tileSize.size ();
+  const int64_t contentIndex = segmentCounter < (int64_t) m_playbackData.contentIndex.size ()
+    ? m_playbackData.contentIndex.at (segmentCounter) : segmentCounter;
+
+  // harmonic mean of the throughput of the last segments in bits per microsecond
+  double inverseSum = 0;
+  int64_t samples = 0;
+  for (int64_t i = m_throughput.bytesReceived.size (); i-- > 0 && samples < (int64_t) m_window; )
+    {
+      int64_t duration = m_throughput.transmissionEnd.at (i) - m_throughput.transmissionRequested.at (i);
+      if (duration > 0 && m_throughput.bytesReceived.at (i) > 0)
+        {
+          inverseSum += duration / (m_throughput.bytesReceived.at (i) * 8.0);
+          samples++;
+        }
+    }
+  if (samples == 0)
+    {
+      answer.nextRepIndex = 0;
+      answer.decisionCase = 0;
+      if (tiles > 0)
+        {
+          answer.tileRepIndex.assign (tiles, 0);
+        }
+      return answer;
+    }
+  double throughput = samples / inverseSum;
+  answer.bandwidthEstimate = throughput;
+
+  int64_t bufferNow = GetBufferNow (timeNow);
+  double budget = m_safety * throughput * m_videoData.segmentDuration / 8;
+  answer.decisionCase = 1;
+  if (m_reservoirBuffer > 0 && bufferNow < (int64_t) m_reservoirBuffer)
+    {
+      budget *= bufferNow / (double) m_reservoirBuffer;
+      answer.decisionCase = 2;
+    }
+
+  if (tiles == 0)
+    {
+      int64_t nextRepIndex = 0;
+      while (nextRepIndex < m_highestRepIndex
+             && m_videoData.segmentSize.at (nextRepIndex + 1).at (contentIndex) <= budget)
+        {
+          nextRepIndex++;
+        }
+      answer.nextRepIndex = nextRepIndex;
+      return answer;
+    }
+
+  m_tileRepIndex.assign (tiles, 0);
+  for (int64_t tile = 0; tile < tiles; tile++)
+    {
+      budget -= m_videoData.tileSize.at (tile).at (0).at (contentIndex);
+    }
+  while (true)
+    {
+      int64_t best = -1;
+      double bestUtility = 0;
+      for (int64_t tile = 0; tile < tiles; tile++)
+        {
+          int64_t rep = m_tileRepIndex.at (tile);
+          if (rep == m_highestRepIndex)
+            {
+              continue;
+            }
+          int64_t bytes = m_videoData.tileSize.at (tile).at (rep + 1).at (contentIndex)
+            - m_videoData.tileSize.at (tile).at (rep).at (contentIndex);
+          if (bytes > budget)
+            {
+              continue;
+            }
+          double weight = m_outsideWeight;
+          if (tile < (int64_t) m_playbackData.tileWeights.size ())
+            {
+              weight += m_playbackData.tileWeights.at (tile);
+            }
+          double utility = weight * std::log (m_videoData.averageBitrate.at (rep + 1) / m_videoData.averageBitrate.at (rep))
+            / std::max (bytes, (int64_t) 1);
+          if (utility > bestUtility)
+            {
+              best = tile;
+              bestUtility = utility;
+            }
+        }
+      if (best < 0)
+        {
+          break;
+        }
+      int64_t rep = m_tileRepIndex.at (best);
+      budget -= m_videoData.tileSize.at (best).at (rep + 1).at (contentIndex)
+        - m_videoData.tileSize.at (best).at (rep).at (contentIndex);
+      m_tileRepIndex.at (best) = rep + 1;
+    }
+
+  // report the quality in the centre of the predicted viewport
+  int64_t viewed = 0;
+  for (int64_t tile = 1; tile < (int64_t) m_playbackData.tileWeights.size () && tile < tiles; tile++)
+    {
+      if (m_playbackData.tileWeights.at (tile) > m_playbackData.tileWeights.at (viewed))
+        {
+          viewed = tile;
+        }
+    }
+  answer.nextRepIndex = m_tileRepIndex.at (viewed);
+  answer.tileRepIndex = m_tileRepIndex;
+  return answer;
+}
+} // namespace ns3
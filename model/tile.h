@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TILE_ALGORITHM_H
+#define TILE_ALGORITHM_H
+
+#include "tcp-stream-adaptation-algorithm.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup tcpStream
+ * \brief Viewport-driven rate allocation over the tiles of a tiled 360 degree video
+ *
+ * The byte budget of the next segment is Safety times the harmonic mean of the throughput of the last
+ * Window segments times the segment duration, scaled down by the share of the buffer below
+ * ReservoirBuffer. All tiles start at the lowest representation, then the budget is spent greedily on
+ * the step of one tile to its next representation with the highest utility per byte, the utility being
+ * the tile's predicted viewport share (playbackData::tileWeights) plus OutsideWeight times the log of the
+ * bitrate ratio of the step. The representation of the tile with the highest viewport share is reported
+ * as nextRepIndex. On a video that isn't tiled the algorithm behaves as a throughput rule with the same
+ * budget.
+ */
+class TileAlgorithm : public AdaptationAlgorithm
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  TileAlgorithm (  const videoData &videoData,
+                   const playbackData & playbackData,
+                   const bufferData & bufferData,
+                   const throughputData & throughput);
+
+  algorithmReply GetNextRep (const int64_t segmentCounter, int64_t clientId);
+
+private:
+  const int64_t m_highestRepIndex;
+  double m_safety; //!< the share of the estimated throughput the budget may use
+  uint32_t m_window; //!< the number of segments of the harmonic throughput mean
+  double m_outsideWeight; //!< the utility weight added to every tile, so that tiles outside the predicted viewport are not left at the lowest quality when the budget allows more
+  uint64_t m_reservoirBuffer; //!< the buffer level in microseconds below which the budget shrinks
+  std::vector<int64_t> m_tileRepIndex; //!< scratch space: the representation of every tile
+};
+} // namespace ns3
+#endif /* TILE_ALGORITHM_H */
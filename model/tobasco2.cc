@@ -17,6 +17,8 @@
  */
 
 #include "tobasco2.h"
+#include "ns3/double.h"
+#include "ns3/integer.h"
 
 namespace ns3 {
 
@@ -24,22 +26,71 @@ NS_LOG_COMPONENT_DEFINE ("TobascoAlgorithm");
 
 NS_OBJECT_ENSURE_REGISTERED (TobascoAlgorithm);
 
+TypeId
+TobascoAlgorithm::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TobascoAlgorithm")
+    .SetParent<AdaptationAlgorithm> ()
+    .SetGroupName ("Applications")
+    .AddAttribute ("A1",
+                   "Share of the throughput the current bitrate may use for the fast start to go on",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&TobascoAlgorithm::m_a1),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("A2",
+                   "Share of the throughput the next higher bitrate may use during the fast start below BMin",
+                   DoubleValue (0.33),
+                   MakeDoubleAccessor (&TobascoAlgorithm::m_a2),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("A3",
+                   "Share of the throughput the next higher bitrate may use during the fast start below BLow",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&TobascoAlgorithm::m_a3),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("A4",
+                   "Share of the throughput the next higher bitrate may use during the fast start above BLow",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&TobascoAlgorithm::m_a4),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("A5",
+                   "Share of the throughput above which the next higher bitrate is not requested after the fast start",
+                   DoubleValue (0.9),
+                   MakeDoubleAccessor (&TobascoAlgorithm::m_a5),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("BMin",
+                   "The minimum buffer level in microseconds",
+                   IntegerValue (5000000),
+                   MakeIntegerAccessor (&TobascoAlgorithm::m_bMin),
+                   MakeIntegerChecker<int64_t> (0))
+    .AddAttribute ("BLow",
+                   "The low buffer level in microseconds",
+                   IntegerValue (20000000),
+                   MakeIntegerAccessor (&TobascoAlgorithm::m_bLow),
+                   MakeIntegerChecker<int64_t> (0))
+    .AddAttribute ("BHigh",
+                   "The high buffer level in microseconds, the optimal level is halfway between BLow and BHigh",
+                   IntegerValue (40000000),
+                   MakeIntegerAccessor (&TobascoAlgorithm::m_bHigh),
+                   MakeIntegerChecker<int64_t> (0))
+    .AddAttribute ("DeltaBeta",
+                   "The fast start goes on while segments complete at most this many microseconds (and at most a segment duration) apart",
+                   IntegerValue (1000000),
+                   MakeIntegerAccessor (&TobascoAlgorithm::m_deltaBeta),
+                   MakeIntegerChecker<int64_t> (0))
+    .AddAttribute ("DeltaTime",
+                   "The interval in microseconds over which the throughput is averaged",
+                   IntegerValue (10000000),
+                   MakeIntegerAccessor (&TobascoAlgorithm::m_deltaTime),
+                   MakeIntegerChecker<int64_t> (1))
+  ;
+  return tid;
+}
+
 TobascoAlgorithm::TobascoAlgorithm (  const videoData &videoData,
                                       const playbackData & playbackData,
                                       const bufferData & bufferData,
                                       const throughputData & throughput) :
   AdaptationAlgorithm (videoData, playbackData, bufferData, throughput),
-  m_a1 (0.75),
-  m_a2 (0.33),
-  m_a3 (0.5),
-  m_a4 (0.75),
-  m_a5 (0.9),
-  m_bMin (5000000),
-  m_bLow (20000000),
-  m_bHigh (40000000),
-  m_bOpt ((int64_t)(0.5 * (m_bLow + m_bHigh))),
-  m_deltaBeta (1000000),
-  m_deltaTime (10000000),
   m_highestRepIndex (videoData.averageBitrate.size () - 1)
 {
   NS_LOG_INFO (this);
@@ -47,6 +98,12 @@ TobascoAlgorithm::TobascoAlgorithm (  const videoData &videoData,
   NS_ASSERT_MSG (m_highestRepIndex >= 0, "The highest quality representation index should be >= 0");
 }
 
+void
+TobascoAlgorithm::DoConstruct (void)
+{
+  m_bOpt = (int64_t)(0.5 * (m_bLow + m_bHigh));
+}
+
 algorithmReply
 TobascoAlgorithm::GetNextRep ( const int64_t segmentCounter, int64_t clientId)
 {
@@ -122,16 +179,16 @@ TobascoAlgorithm::GetNextRep ( const int64_t segmentCounter, int64_t clientId)
             }
           else if (bufferNow < m_bLow)
             {
-              double lastSegmentThroughput = (8.0 * m_videoData.segmentSize.at (m_lastRepIndex).at (segmentCounter - 1))
+              double lastSegmentThroughput = (8.0 * m_videoData.segmentSize.at (m_lastRepIndex).at (m_playbackData.contentIndex.at (segmentCounter - 1)))
                 / ((double)(m_throughput.transmissionEnd.at (segmentCounter - 1) - m_throughput.transmissionStart.at (segmentCounter - 1)) / 1000000.0);
 
               if ((m_lastRepIndex != 0)
-                  && ((8.0 * m_videoData.segmentSize.at (m_lastRepIndex).at (segmentCounter - 1)) / timeFactor >= lastSegmentThroughput))
+                  && ((8.0 * m_videoData.segmentSize.at (m_lastRepIndex).at (m_playbackData.contentIndex.at (segmentCounter - 1))) / timeFactor >= lastSegmentThroughput))
                 {
                   decisionCase = 5;
                   for (int i = m_highestRepIndex; i >= 0; i--)
                     {
-                      if ((8.0 * m_videoData.segmentSize.at (i).at (segmentCounter - 1)) / timeFactor >= lastSegmentThroughput)
+                      if ((8.0 * m_videoData.segmentSize.at (i).at (m_playbackData.contentIndex.at (segmentCounter - 1))) / timeFactor >= lastSegmentThroughput)
                         {
                           continue;
                         }